@@ -0,0 +1,1318 @@
+#ifndef __BTREE_HPP
+#define __BTREE_HPP
+
+#include <cstddef> // for size_t
+#include <cstring> // for memcpy, memmove
+#include <iterator> // for bidirectional iterator tag
+#include <limits> // for numeric_limits
+#include <algorithm> // for min
+#include <memory> // for allocator
+#include <stdexcept> // for length_error
+
+#include "__config.hpp"
+#include "iterator.hpp"
+#include "utility.hpp"
+#include "iterator_traits.hpp"
+#include "algorithm.hpp" // for swap, equal and lexicographical_compare
+#include "type_traits.hpp" // for enable_if and is_bitwise_copyable
+#include "pool_allocator.hpp" // for __select_on_copy
+#include "__btree_search.hpp"
+
+#if FT_CXX11
+#include <type_traits> // for is_nothrow_move_constructible
+#include <utility> // for move, forward
+#endif
+
+namespace ft {
+
+template <class _Key, class _Tp, class _KeyGetter, class _Compare,
+          class _Allocator = std::allocator<_Tp> >
+struct __btree_traits {
+
+  typedef _Key        key_type;
+  typedef _Tp         value_type;
+  typedef _KeyGetter  key_getter;
+  typedef _Compare    key_compare;
+  typedef _Allocator  allocator_type;
+
+}; // __btree_traits
+
+/*
+** B-tree under btree_map and btree_set
+**
+** A node holds up to kSlots values in key order in a single block, and an
+** internal node also kSlots + 1 children, the values of child i going between
+** its values i - 1 and i. All the leaves are at the same depth.
+**
+** Q: What does it buy over __tree?
+** A: A lookup in __tree reads one node per level, about one cache miss each,
+**    over some log2(n) levels. A node here spans a few cache lines read in a
+**    row and divides the keys by up to kSlots + 1 per level, so 100M int keys
+**    take 6 levels instead of about 30. Leaves, which hold most of the values,
+**    have no child links, so a value costs little more than its own size where
+**    a __tree node adds three words to it.
+**
+** Q: What does it cost?
+** A: Insertions and erasures move values inside and between nodes, so unlike
+**    with map and set they invalidate iterators, pointers and references to
+**    elements. Values are moved with memmove when they are bitwise copyable,
+**    by move construction in C++11 and by copy otherwise. Such a move must not
+**    throw, which C++98 copies of strings only do when memory runs out.
+*/
+
+// Values per node, such that a leaf takes about kTargetBytes, within [3, 64]
+
+template <class _Value>
+struct __btree_slots {
+  static const std::size_t kTargetBytes = 256;
+  static const std::size_t kHeaderBytes = 2 * sizeof(void*);
+  static const std::size_t kFit = (kTargetBytes - kHeaderBytes) / sizeof(_Value);
+  static const std::size_t value = kFit < 3 ? 3 : (64 < kFit ? 64 : kFit);
+};
+
+template <class _BtreeTraits>
+struct __btree_internal_node;
+
+template <class _BtreeTraits>
+struct __btree_node {
+
+  typedef typename _BtreeTraits::allocator_type  allocator_type;
+  typedef typename allocator_type::value_type    value_type;
+  typedef __btree_node*                          node_pointer;
+
+  static const std::size_t kSlots = __btree_slots<value_type>::value;
+
+  // Raw storage for the values, constructed in place as they come
+
+  union __storage {
+    char __bytes_[kSlots * sizeof(value_type)];
+    long double __ld_;
+    double __d_;
+    long __l_;
+    void* __p_;
+  };
+
+  node_pointer __parent_;
+  unsigned short __position_; // index among the children of __parent_
+  unsigned short __count_;
+  bool __leaf_;
+  __storage __slots_;
+
+  value_type& __value(int __i) { return reinterpret_cast<value_type*>(__slots_.__bytes_)[__i]; }
+
+  node_pointer& __child(int __i) {
+    return static_cast<__btree_internal_node<_BtreeTraits>*>(this)->__children_[__i];
+  }
+
+  // Steps from value __i of __x to the next one, or past the last value of
+  // the last leaf, which is end()
+
+  static void __next(node_pointer& __x, int& __i) {
+    if (!__x->__leaf_) {
+      __x = __x->__child(__i + 1);
+      while (!__x->__leaf_) {
+        __x = __x->__child(0);
+      }
+      __i = 0;
+    } else if (++__i == __x->__count_) {
+      node_pointer __y = __x;
+      int __j = __i;
+      while (__j == __y->__count_ && __y->__parent_ != NULL) {
+        __j = __y->__position_;
+        __y = __y->__parent_;
+      }
+      if (__j < __y->__count_) {
+        __x = __y;
+        __i = __j;
+      }
+    }
+  }
+
+  static void __prev(node_pointer& __x, int& __i) {
+    if (!__x->__leaf_) {
+      __x = __x->__child(__i);
+      while (!__x->__leaf_) {
+        __x = __x->__child(__x->__count_);
+      }
+      __i = __x->__count_ - 1;
+    } else if (__i != 0) {
+      --__i;
+    } else {
+      node_pointer __y = __x;
+      int __j = 0;
+      while (__j == 0 && __y->__parent_ != NULL) {
+        __j = __y->__position_;
+        __y = __y->__parent_;
+      }
+      if (__j != 0) {
+        __x = __y;
+        __i = __j - 1;
+      }
+    }
+  }
+
+}; // __btree_node
+
+template <class _BtreeTraits>
+struct __btree_internal_node : public __btree_node<_BtreeTraits> {
+
+  __btree_node<_BtreeTraits>* __children_[__btree_node<_BtreeTraits>::kSlots + 1];
+
+}; // __btree_internal_node
+
+template <class _BtreeTraits>
+class __btree;
+
+template <class _BtreeTraits>
+class __btree_iterator {
+ public:
+  typedef typename std::bidirectional_iterator_tag     iterator_category;
+  typedef typename _BtreeTraits::allocator_type        allocator_type;
+  typedef typename allocator_type::value_type          value_type;
+  typedef typename allocator_type::difference_type     difference_type;
+  typedef typename allocator_type::pointer             pointer;
+  typedef typename allocator_type::reference           reference;
+
+  typedef __btree_node<_BtreeTraits>                   node;
+  typedef node*                                        node_pointer;
+
+ private:
+  friend class __btree<_BtreeTraits>;
+
+  node_pointer __node_ptr_;
+  int __position_;
+
+ public:
+  __btree_iterator() : __node_ptr_(NULL), __position_(0) {}
+
+  __btree_iterator(node_pointer __p, int __i) : __node_ptr_(__p), __position_(__i) {}
+
+  __btree_iterator(const __btree_iterator& __x)
+    : __node_ptr_(__x.base()), __position_(__x.position()) {}
+
+  __btree_iterator& operator=(const __btree_iterator& __x) {
+    __node_ptr_ = __x.base();
+    __position_ = __x.position();
+    return *this;
+  }
+
+  ~__btree_iterator() {}
+
+  reference operator*() const { return __node_ptr_->__value(__position_); }
+
+  pointer operator->() const { return &**this; }
+
+  __btree_iterator& operator++() {
+    node::__next(__node_ptr_, __position_);
+    return *this;
+  }
+
+  __btree_iterator operator++(int) {
+    __btree_iterator __tmp = *this;
+    ++*this;
+    return __tmp;
+  }
+
+  __btree_iterator& operator--() {
+    node::__prev(__node_ptr_, __position_);
+    return *this;
+  }
+
+  __btree_iterator operator--(int) {
+    __btree_iterator __tmp = *this;
+    --*this;
+    return __tmp;
+  }
+
+  bool operator==(const __btree_iterator& __x) const {
+    return __node_ptr_ == __x.base() && __position_ == __x.position();
+  }
+
+  bool operator!=(const __btree_iterator& __x) const {
+    return !(*this == __x);
+  }
+
+  node_pointer base() const { return __node_ptr_; }
+
+  int position() const { return __position_; }
+
+}; // __btree_iterator class
+
+template <class _BtreeTraits>
+class __btree_const_iterator {
+ public:
+  typedef typename std::bidirectional_iterator_tag     iterator_category;
+  typedef typename _BtreeTraits::allocator_type        allocator_type;
+  typedef typename allocator_type::value_type          value_type;
+  typedef typename allocator_type::difference_type     difference_type;
+  typedef typename allocator_type::const_pointer       pointer;
+  typedef typename allocator_type::const_reference     reference;
+
+  typedef __btree_node<_BtreeTraits>                   node;
+  typedef node*                                        node_pointer;
+
+ private:
+  typedef __btree_iterator<_BtreeTraits> non_const_iterator;
+
+  node_pointer __node_ptr_;
+  int __position_;
+
+ public:
+  __btree_const_iterator() : __node_ptr_(NULL), __position_(0) {}
+
+  __btree_const_iterator(node_pointer __p, int __i) : __node_ptr_(__p), __position_(__i) {}
+
+  __btree_const_iterator(const __btree_const_iterator& __x)
+    : __node_ptr_(__x.base()), __position_(__x.position()) {}
+
+  __btree_const_iterator(const non_const_iterator& __x)
+    : __node_ptr_(__x.base()), __position_(__x.position()) {}
+
+  __btree_const_iterator& operator=(const __btree_const_iterator& __x) {
+    __node_ptr_ = __x.base();
+    __position_ = __x.position();
+    return *this;
+  }
+
+  ~__btree_const_iterator() {}
+
+  reference operator*() const { return __node_ptr_->__value(__position_); }
+
+  pointer operator->() const { return &**this; }
+
+  __btree_const_iterator& operator++() {
+    node::__next(__node_ptr_, __position_);
+    return *this;
+  }
+
+  __btree_const_iterator operator++(int) {
+    __btree_const_iterator __tmp = *this;
+    ++*this;
+    return __tmp;
+  }
+
+  __btree_const_iterator& operator--() {
+    node::__prev(__node_ptr_, __position_);
+    return *this;
+  }
+
+  __btree_const_iterator operator--(int) {
+    __btree_const_iterator __tmp = *this;
+    --*this;
+    return __tmp;
+  }
+
+  bool operator==(const __btree_const_iterator& __x) const {
+    return __node_ptr_ == __x.base() && __position_ == __x.position();
+  }
+
+  bool operator!=(const __btree_const_iterator& __x) const {
+    return !(*this == __x);
+  }
+
+  node_pointer base() const { return __node_ptr_; }
+
+  int position() const { return __position_; }
+
+}; // __btree_const_iterator
+
+// Comparison of non-const iterator and const iterator
+
+template <class _BtreeTraits>
+bool operator==(const __btree_iterator<_BtreeTraits>& __x,
+                const __btree_const_iterator<_BtreeTraits>& __y) {
+  return __x.base() == __y.base() && __x.position() == __y.position();
+}
+
+template <class _BtreeTraits>
+bool operator!=(const __btree_iterator<_BtreeTraits>& __x,
+                const __btree_const_iterator<_BtreeTraits>& __y) {
+  return !(__x == __y);
+}
+
+template <class _BtreeTraits>
+class __btree {
+
+ public:
+  typedef __btree<_BtreeTraits>                       tree;
+  typedef typename _BtreeTraits::key_type             key_type;
+  typedef const key_type&                             key_reference;
+  typedef typename _BtreeTraits::key_compare          key_compare;
+  typedef typename _BtreeTraits::value_type           value_type;
+  typedef typename _BtreeTraits::allocator_type       allocator_type;
+  typedef typename _BtreeTraits::key_getter           key_getter;
+  typedef typename allocator_type::size_type          size_type;
+  typedef typename allocator_type::difference_type    difference_type;
+  typedef typename allocator_type::pointer            pointer;
+  typedef typename allocator_type::const_pointer      const_pointer;
+  typedef typename allocator_type::reference          reference;
+  typedef typename allocator_type::const_reference    const_reference;
+  typedef __btree_iterator<_BtreeTraits>              iterator;
+  typedef __btree_const_iterator<_BtreeTraits>        const_iterator;
+  typedef ft::reverse_iterator<iterator>              reverse_iterator;
+  typedef ft::reverse_iterator<const_iterator>        const_reverse_iterator;
+
+  typedef __btree_node<_BtreeTraits>                  node;
+  typedef node*                                       node_pointer;
+  typedef __btree_internal_node<_BtreeTraits>         internal_node;
+  typedef internal_node*                              internal_pointer;
+
+  typedef ft::pair<iterator, bool>                    pair_ib;
+  typedef ft::pair<iterator, iterator>                pair_ii;
+  typedef ft::pair<const_iterator, const_iterator>    pair_cc;
+
+  static const int kSlots = static_cast<int>(node::kSlots);
+
+  // Nodes other than the root with fewer values are merged or refilled after
+  // an erasure. Splits leave at least that many on each side, but for the
+  // ones at the ends of the tree (see __split).
+
+  static const int kMinValues = (kSlots - 1) / 2;
+
+ protected:
+
+  typedef ft::integral_constant<bool,
+      ft::is_bitwise_copyable<value_type>::value
+      && ft::__has_trivial_construct<allocator_type>::value>  __bitwise_copy_tag;
+
+  typedef ft::__btree_search<key_type, key_compare>           __search;
+
+  // Member variables
+
+  node_pointer __root_;
+  node_pointer __lmost_;
+  node_pointer __rmost_;
+  size_type __size_;
+  key_compare __comp_;
+  allocator_type __alloc_value_;
+  typename allocator_type::template rebind<node>::other __alloc_leaf_;
+  typename allocator_type::template rebind<internal_node>::other __alloc_internal_;
+
+  static key_reference __key(node_pointer __x, int __i) {
+    return key_getter()(__x->__value(__i));
+  }
+
+ public:
+
+  __btree(const key_compare& __comp, const allocator_type& __a)
+    : __root_(NULL), __lmost_(NULL), __rmost_(NULL), __size_(0), __comp_(__comp),
+      __alloc_value_(__a), __alloc_leaf_(__a), __alloc_internal_(__a) {}
+
+  __btree(const tree& __t)
+    : __root_(NULL), __lmost_(NULL), __rmost_(NULL), __size_(0), __comp_(__t.key_comp()),
+      __alloc_value_(ft::__select_on_copy(__t.__alloc_value_)),
+      __alloc_leaf_(__alloc_value_), __alloc_internal_(__alloc_value_) {
+    __copy(__t);
+  }
+
+#if FT_CXX11
+  __btree(tree&& __t)
+    : __root_(NULL), __lmost_(NULL), __rmost_(NULL), __size_(0), __comp_(__t.key_comp()),
+      __alloc_value_(__t.get_allocator()), __alloc_leaf_(__alloc_value_),
+      __alloc_internal_(__alloc_value_) {
+    swap(__t);
+  }
+#endif
+
+  ~__btree() { clear(); }
+
+  tree& operator=(const tree& __t) {
+    if (this != &__t) {
+      clear();
+      __comp_ = __t.key_comp();
+      __copy(__t);
+    }
+    return *this;
+  }
+
+#if FT_CXX11
+  tree& operator=(tree&& __t) {
+    if (this != &__t) {
+      clear();
+      swap(__t);
+    }
+    return *this;
+  }
+#endif
+
+  iterator begin() { return iterator(__lmost_, 0); }
+
+  const_iterator begin() const { return const_iterator(__lmost_, 0); }
+
+  iterator end() { return iterator(__rmost_, __rmost_ == NULL ? 0 : __rmost_->__count_); }
+
+  const_iterator end() const {
+    return const_iterator(__rmost_, __rmost_ == NULL ? 0 : __rmost_->__count_);
+  }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  size_type size() const { return __size_; }
+
+  size_type max_size() const {
+    return std::min<size_type>(__alloc_value_.max_size(),
+                               std::numeric_limits<difference_type>::max());
+  }
+
+  // Insertion
+
+  pair_ib insert(const value_type& __v) {
+    __make_copy __make = {__v};
+    return __emplace_unique_key(key_getter()(__v), __make);
+  }
+
+  iterator insert(iterator __it, const value_type& __v) {
+    __make_copy __make = {__v};
+    return __emplace_hint_unique_key(__it, key_getter()(__v), __make);
+  }
+
+  template <class _Iterator>
+  void insert(_Iterator __first, _Iterator __last) {
+    for (; __first != __last; ++__first) {
+      insert(end(), *__first);
+    }
+  }
+
+  // The caller guarantees that the keys of [__first, __last) are strictly
+  // increasing, so an empty tree is filled by appending without comparing them
+
+  template <class _Iterator>
+  void insert_sorted_unique(_Iterator __first, _Iterator __last) {
+    if (__size_ != 0) {
+      insert(__first, __last);
+      return;
+    }
+    for (; __first != __last; ++__first) {
+      __make_copy __make = {*__first};
+      if (__root_ == NULL) {
+        __new_root();
+      }
+      __insert_at(__rmost_, __rmost_->__count_, __make);
+    }
+  }
+
+#if FT_CXX11
+  // The value has to be built to know its key, so it is built aside and
+  // moved into its slot
+
+  template <class... _Args>
+  pair_ib emplace(_Args&&... __args) {
+    value_type __v(std::forward<_Args>(__args)...);
+    return __emplace_unique_key(key_getter()(__v), [&](allocator_type& __a, pointer __p) {
+      std::allocator_traits<allocator_type>::construct(__a, __p, std::move(__v));
+    });
+  }
+
+  template <class... _Args>
+  iterator emplace_hint(iterator __it, _Args&&... __args) {
+    value_type __v(std::forward<_Args>(__args)...);
+    return __emplace_hint_unique_key(__it, key_getter()(__v), [&](allocator_type& __a, pointer __p) {
+      std::allocator_traits<allocator_type>::construct(__a, __p, std::move(__v));
+    });
+  }
+#endif
+
+  /*
+  ** Looks __k up and, only if it is missing, calls __make(__alloc_value_, __p)
+  ** to build the new value at __p, in the slot it goes to, as
+  ** __tree::__emplace_unique_key does
+  */
+
+  template <class _Make>
+  pair_ib __emplace_unique_key(const key_type& __k, _Make __make) {
+    if (__root_ == NULL) {
+      __new_root();
+    }
+    node_pointer __x = __root_;
+    for (;;) {
+      int __i = __lower_in(__x, __k);
+      if (__i < __x->__count_ && !__comp_(__k, __key(__x, __i))) {
+        return pair_ib(iterator(__x, __i), false);
+      }
+      if (__x->__leaf_) {
+        return pair_ib(__insert_at(__x, __i, __make), true);
+      }
+      __x = __x->__child(__i);
+    }
+  }
+
+  // Inserts right before __it when __k goes there, else looks __k up
+
+  template <class _Make>
+  iterator __emplace_hint_unique_key(iterator __it, const key_type& __k, _Make __make) {
+    if (__size_ != 0 && (__it == end() || __comp_(__k, key_getter()(*__it)))) {
+      if (__it == begin()) {
+        return __insert_at(__it.base(), 0, __make);
+      }
+      iterator __prev = __it;
+      --__prev;
+      if (__comp_(key_getter()(*__prev), __k)) {
+        return __it.base()->__leaf_ ? __insert_at(__it.base(), __it.position(), __make)
+                                    : __insert_at(__prev.base(), __prev.position() + 1, __make);
+      }
+    }
+    return __emplace_unique_key(__k, __make).first;
+  }
+
+  // Erasure
+
+  // Returns the iterator to the value after the erased one
+
+  iterator erase(iterator __p) {
+    node_pointer __x = __p.base();
+    int __i = __p.position();
+    __alloc_value_.destroy(&__x->__value(__i));
+    if (!__x->__leaf_) {
+      // The first value of the next leaf takes the place of the erased one
+      node_pointer __l = __x->__child(__i + 1);
+      while (!__l->__leaf_) {
+        __l = __l->__child(0);
+      }
+      __relocate(&__l->__value(0), 1, &__x->__value(__i));
+      __relocate(&__l->__value(1), __l->__count_ - 1, &__l->__value(0));
+      __x = __l;
+    } else {
+      __relocate(&__x->__value(__i + 1), __x->__count_ - __i - 1, &__x->__value(__i));
+    }
+    --__x->__count_;
+    --__size_;
+    __rebalance(__x, __p);
+    return __size_ == 0 ? end() : __first_from(__p);
+  }
+
+  size_type erase(const key_type& __k) {
+    iterator __it = find(__k);
+    if (__it == end()) {
+      return 0;
+    }
+    erase(__it);
+    return 1;
+  }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, size_type>::type
+  erase(const _K2& __k) {
+    iterator __first = lower_bound(__k);
+    size_type __n = static_cast<size_type>(ft::distance(__first, upper_bound(__k)));
+    __erase_n(__first, __n);
+    return __n;
+  }
+
+  void erase(iterator __first, iterator __last) {
+    if (__first == begin() && __last == end()) {
+      clear();
+    } else {
+      __erase_n(__first, static_cast<size_type>(ft::distance(__first, __last)));
+    }
+  }
+
+  void clear() {
+    if (__root_ != NULL) {
+      __destroy(__root_);
+    }
+    __root_ = NULL;
+    __lmost_ = NULL;
+    __rmost_ = NULL;
+    __size_ = 0;
+  }
+
+  void swap(tree& __x) {
+    ft::swap(__root_, __x.__root_);
+    ft::swap(__lmost_, __x.__lmost_);
+    ft::swap(__rmost_, __x.__rmost_);
+    ft::swap(__size_, __x.__size_);
+    ft::swap(__comp_, __x.__comp_);
+    ft::swap(__alloc_value_, __x.__alloc_value_);
+    ft::swap(__alloc_leaf_, __x.__alloc_leaf_);
+    ft::swap(__alloc_internal_, __x.__alloc_internal_);
+  }
+
+  // Observers
+
+  key_compare key_comp() const { return __comp_; }
+
+  allocator_type get_allocator() const { return __alloc_value_; }
+
+  // Lookup
+
+  iterator find(const key_type& __k) { return __find(__k); }
+
+  const_iterator find(const key_type& __k) const { return __find(__k); }
+
+  size_type count(const key_type& __k) const { return __find(__k) == end() ? 0 : 1; }
+
+  iterator lower_bound(const key_type& __k) { return __lbound(__k); }
+
+  const_iterator lower_bound(const key_type& __k) const { return __lbound(__k); }
+
+  iterator upper_bound(const key_type& __k) { return __ubound(__k); }
+
+  const_iterator upper_bound(const key_type& __k) const { return __ubound(__k); }
+
+  pair_ii equal_range(const key_type& __k) {
+    iterator __it = __lbound(__k);
+    return pair_ii(__it, __is_key_of(__k, __it) ? ++iterator(__it) : __it);
+  }
+
+  pair_cc equal_range(const key_type& __k) const {
+    const_iterator __it = __lbound(__k);
+    return pair_cc(__it, __is_key_of(__k, __it) ? ++const_iterator(__it) : __it);
+  }
+
+  // Lookups by keys of another type, for transparent comparators
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  find(const _K2& __k) { return __find(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  find(const _K2& __k) const { return __find(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, size_type>::type
+  count(const _K2& __k) const {
+    return static_cast<size_type>(ft::distance(__lbound(__k), __ubound(__k)));
+  }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  lower_bound(const _K2& __k) { return __lbound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  lower_bound(const _K2& __k) const { return __lbound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  upper_bound(const _K2& __k) { return __ubound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  upper_bound(const _K2& __k) const { return __ubound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, pair_ii>::type
+  equal_range(const _K2& __k) { return pair_ii(__lbound(__k), __ubound(__k)); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, pair_cc>::type
+  equal_range(const _K2& __k) const { return pair_cc(__lbound(__k), __ubound(__k)); }
+
+ protected:
+
+  struct __make_copy {
+    const value_type& __v_;
+
+    void operator()(allocator_type& __a, pointer __p) const { __a.construct(__p, __v_); }
+  };
+
+  // In-node searches: first value whose key is not before __k, or after it.
+  // Keys of the key type are counted when __search allows it.
+
+  template <class _K2>
+  int __lower_in(node_pointer __x, const _K2& __k) const { return __bsearch_lower(__x, __k); }
+
+  template <class _K2>
+  int __upper_in(node_pointer __x, const _K2& __k) const { return __bsearch_upper(__x, __k); }
+
+  int __lower_in(node_pointer __x, const key_type& __k) const {
+    return __lower_in(__x, __k, ft::integral_constant<bool, __search::value>());
+  }
+
+  int __upper_in(node_pointer __x, const key_type& __k) const {
+    return __upper_in(__x, __k, ft::integral_constant<bool, __search::value>());
+  }
+
+  int __lower_in(node_pointer __x, const key_type& __k, ft::true_type) const {
+    return __search::__lower(__key_bytes(__x), sizeof(value_type), __x->__count_, __k);
+  }
+
+  int __lower_in(node_pointer __x, const key_type& __k, ft::false_type) const {
+    return __bsearch_lower(__x, __k);
+  }
+
+  int __upper_in(node_pointer __x, const key_type& __k, ft::true_type) const {
+    return __search::__upper(__key_bytes(__x), sizeof(value_type), __x->__count_, __k);
+  }
+
+  int __upper_in(node_pointer __x, const key_type& __k, ft::false_type) const {
+    return __bsearch_upper(__x, __k);
+  }
+
+  // Address of the first key of __x, the next ones following every
+  // sizeof(value_type) bytes
+
+  static const char* __key_bytes(node_pointer __x) {
+    return reinterpret_cast<const char*>(&key_getter()(__x->__value(0)));
+  }
+
+  template <class _K2>
+  int __bsearch_lower(node_pointer __x, const _K2& __k) const {
+    int __lo = 0;
+    int __hi = __x->__count_;
+    while (__lo < __hi) {
+      int __mid = (__lo + __hi) / 2;
+      if (__comp_(__key(__x, __mid), __k)) {
+        __lo = __mid + 1;
+      } else {
+        __hi = __mid;
+      }
+    }
+    return __lo;
+  }
+
+  template <class _K2>
+  int __bsearch_upper(node_pointer __x, const _K2& __k) const {
+    int __lo = 0;
+    int __hi = __x->__count_;
+    while (__lo < __hi) {
+      int __mid = (__lo + __hi) / 2;
+      if (!__comp_(__k, __key(__x, __mid))) {
+        __lo = __mid + 1;
+      } else {
+        __hi = __mid;
+      }
+    }
+    return __lo;
+  }
+
+  // The last value found on the way down is the closest to __k
+
+  template <class _K2>
+  iterator __lbound(const _K2& __k) const {
+    iterator __r = const_cast<tree*>(this)->end();
+    for (node_pointer __x = __root_; __x != NULL; ) {
+      int __i = __lower_in(__x, __k);
+      if (__i < __x->__count_) {
+        __r = iterator(__x, __i);
+      }
+      __x = __x->__leaf_ ? NULL : __x->__child(__i);
+    }
+    return __r;
+  }
+
+  template <class _K2>
+  iterator __ubound(const _K2& __k) const {
+    iterator __r = const_cast<tree*>(this)->end();
+    for (node_pointer __x = __root_; __x != NULL; ) {
+      int __i = __upper_in(__x, __k);
+      if (__i < __x->__count_) {
+        __r = iterator(__x, __i);
+      }
+      __x = __x->__leaf_ ? NULL : __x->__child(__i);
+    }
+    return __r;
+  }
+
+  template <class _K2>
+  iterator __find(const _K2& __k) const {
+    for (node_pointer __x = __root_; __x != NULL; ) {
+      int __i = __lower_in(__x, __k);
+      if (__i < __x->__count_ && !__comp_(__k, __key(__x, __i))) {
+        return iterator(__x, __i);
+      }
+      __x = __x->__leaf_ ? NULL : __x->__child(__i);
+    }
+    return const_cast<tree*>(this)->end();
+  }
+
+  template <class _Iter>
+  bool __is_key_of(const key_type& __k, _Iter __it) const {
+    return __it != end() && !__comp_(__k, key_getter()(*__it));
+  }
+
+  // Nodes
+
+  node_pointer __new_leaf() {
+    node_pointer __x = __alloc_leaf_.allocate(1);
+    __x->__parent_ = NULL;
+    __x->__position_ = 0;
+    __x->__count_ = 0;
+    __x->__leaf_ = true;
+    return __x;
+  }
+
+  node_pointer __new_internal() {
+    node_pointer __x = __alloc_internal_.allocate(1);
+    __x->__parent_ = NULL;
+    __x->__position_ = 0;
+    __x->__count_ = 0;
+    __x->__leaf_ = false;
+    return __x;
+  }
+
+  void __free_node(node_pointer __x) {
+    if (__x->__leaf_) {
+      __alloc_leaf_.deallocate(__x, 1);
+    } else {
+      __alloc_internal_.deallocate(static_cast<internal_pointer>(__x), 1);
+    }
+  }
+
+  void __new_root() {
+    __root_ = __new_leaf();
+    __lmost_ = __root_;
+    __rmost_ = __root_;
+  }
+
+  void __set_child(node_pointer __x, int __i, node_pointer __c) {
+    __x->__child(__i) = __c;
+    __c->__parent_ = __x;
+    __c->__position_ = static_cast<unsigned short>(__i);
+  }
+
+  // Destroys the values and frees the nodes of the subtree of __x
+
+  void __destroy(node_pointer __x) {
+    if (!__x->__leaf_) {
+      for (int __i = 0; __i <= __x->__count_; ++__i) {
+        __destroy(__x->__child(__i));
+      }
+    }
+    __destroy_values(__x, 0, __x->__count_);
+    __free_node(__x);
+  }
+
+  void __destroy_values(node_pointer __x, int __first, int __last) {
+    if (!ft::is_trivially_destructible<value_type>::value) {
+      for (; __first != __last; ++__first) {
+        __alloc_value_.destroy(&__x->__value(__first));
+      }
+    }
+  }
+
+  // Moving values
+
+  /*
+  ** Moves the __n values at __first to __result, which may overlap with them
+  ** in any way, leaving their old slots raw
+  **
+  ** Q: Why cast to void*?
+  ** A: gcc warns about memmove on class types without a trivial assignment,
+  **    such as the pair<const Key, T> of maps, which are still bitwise
+  **    copyable
+  */
+
+  void __relocate(value_type* __first, int __n, value_type* __result) {
+    if (__n != 0 && __first != __result) {
+      __relocate(__first, __n, __result, __bitwise_copy_tag());
+    }
+  }
+
+  void __relocate(value_type* __first, int __n, value_type* __result, ft::true_type) {
+    std::memmove(static_cast<void*>(__result), static_cast<const void*>(__first),
+                 __n * sizeof(value_type));
+  }
+
+  void __relocate(value_type* __first, int __n, value_type* __result, ft::false_type) {
+    if (__result < __first) {
+      for (int __i = 0; __i < __n; ++__i) {
+        __relocate_one(__first + __i, __result + __i);
+      }
+    } else {
+      for (int __i = __n; 0 < __i--; ) {
+        __relocate_one(__first + __i, __result + __i);
+      }
+    }
+  }
+
+  void __relocate_one(value_type* __from, value_type* __to) {
+#if FT_CXX11
+    std::allocator_traits<allocator_type>::construct(__alloc_value_, __to, std::move(*__from));
+#else
+    __alloc_value_.construct(__to, *__from);
+#endif
+    __alloc_value_.destroy(__from);
+  }
+
+  // Builds copies of the __n values at __first in the raw slots at __result
+
+  void __construct_copies(value_type* __first, int __n, value_type* __result) {
+    __construct_copies(__first, __n, __result, __bitwise_copy_tag());
+  }
+
+  void __construct_copies(value_type* __first, int __n, value_type* __result, ft::true_type) {
+    std::memcpy(static_cast<void*>(__result), static_cast<const void*>(__first),
+                __n * sizeof(value_type));
+  }
+
+  void __construct_copies(value_type* __first, int __n, value_type* __result, ft::false_type) {
+    int __i = 0;
+    try {
+      for (; __i < __n; ++__i) {
+        __alloc_value_.construct(__result + __i, __first[__i]);
+      }
+    } catch (...) {
+      while (0 < __i--) {
+        __alloc_value_.destroy(__result + __i);
+      }
+      throw;
+    }
+  }
+
+  // Insertion helpers
+
+  // Builds a value at __i in the leaf __x, splitting it first if it is full
+
+  template <class _Make>
+  iterator __insert_at(node_pointer __x, int __i, _Make& __make) {
+    if (__size_ == max_size()) {
+      throw std::length_error("btree_map/btree_set");
+    }
+    if (__x->__count_ == kSlots) {
+      __split(__x, __i);
+    }
+    __relocate(&__x->__value(__i), __x->__count_ - __i, &__x->__value(__i + 1));
+    try {
+      __make(__alloc_value_, &__x->__value(__i));
+    } catch (...) {
+      __relocate(&__x->__value(__i + 1), __x->__count_ - __i, &__x->__value(__i));
+      if (__size_ == 0) {
+        clear();
+      }
+      throw;
+    }
+    ++__x->__count_;
+    ++__size_;
+    return iterator(__x, __i);
+  }
+
+  /*
+  ** Splits the full node __x around a middle value, which goes up into the
+  ** parent, splitting the parent first if it is full too. __x and __i are
+  ** then moved to the node and the position where the value meant for __i
+  ** goes.
+  **
+  ** Q: Why not always split in the middle?
+  ** A: Keys inserted in increasing order always go at the end of the last
+  **    leaf, so the left half would never be filled again and nodes would
+  **    stay half empty. A value going past the end of the nodes on the right
+  **    edge of the tree, or before the start of those on the left edge, only
+  **    takes one or two values to the new node, so sorted insertions fill
+  **    the nodes. The edge nodes may then hold fewer than kMinValues values.
+  */
+
+  void __split(node_pointer& __x, int& __i) {
+    node_pointer __y = __x->__leaf_ ? __new_leaf() : __new_internal();
+    node_pointer __parent = __x->__parent_;
+    try {
+      if (__parent == NULL) {
+        __parent = __new_internal();
+        __set_child(__parent, 0, __x);
+        __root_ = __parent;
+      } else if (__parent->__count_ == kSlots) {
+        int __p = __x->__position_;
+        __split(__parent, __p);
+        __parent = __x->__parent_;
+      }
+    } catch (...) {
+      __free_node(__y);
+      throw;
+    }
+    int __keep = kSlots / 2;
+    if (__i == kSlots && __on_edge(__x, true)) {
+      __keep = kSlots - 2;
+    } else if (__i == 0 && __on_edge(__x, false)) {
+      __keep = 1;
+    }
+    int __moved = kSlots - __keep - 1;
+    __relocate(&__x->__value(__keep + 1), __moved, &__y->__value(0));
+    if (!__x->__leaf_) {
+      for (int __j = 0; __j <= __moved; ++__j) {
+        __set_child(__y, __j, __x->__child(__keep + 1 + __j));
+      }
+    }
+    __y->__count_ = static_cast<unsigned short>(__moved);
+    __x->__count_ = static_cast<unsigned short>(__keep);
+    __insert_separator(__parent, __x->__position_, &__x->__value(__keep), __y);
+    if (__x == __rmost_) {
+      __rmost_ = __y;
+    }
+    if (__keep < __i) {
+      __x = __y;
+      __i -= __keep + 1;
+    }
+  }
+
+  // Tells whether __x is the last (or first) node of its level
+
+  static bool __on_edge(node_pointer __x, bool __right) {
+    for (; __x->__parent_ != NULL; __x = __x->__parent_) {
+      if (__x->__position_ != (__right ? __x->__parent_->__count_ : 0)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Moves the value at __v to position __p of __x, with __y as the child after it
+
+  void __insert_separator(node_pointer __x, int __p, value_type* __v, node_pointer __y) {
+    __relocate(&__x->__value(__p), __x->__count_ - __p, &__x->__value(__p + 1));
+    for (int __j = __x->__count_; __p < __j; --__j) {
+      __set_child(__x, __j + 1, __x->__child(__j));
+    }
+    __relocate(__v, 1, &__x->__value(__p));
+    __set_child(__x, __p + 1, __y);
+    ++__x->__count_;
+  }
+
+  // Erasure helpers
+
+  /*
+  ** Merges or refills the nodes left with too few values, from the leaf __x
+  ** up. __t designates the value after the erased one, or the end of its
+  ** leaf, and follows that value wherever it is moved.
+  */
+
+  void __rebalance(node_pointer __x, iterator& __t) {
+    while (__x != __root_ && __x->__count_ < kMinValues) {
+      node_pointer __parent = __x->__parent_;
+      int __p = __x->__position_;
+      node_pointer __left = __p == 0 ? NULL : __parent->__child(__p - 1);
+      node_pointer __right = __p == __parent->__count_ ? NULL : __parent->__child(__p + 1);
+      if (__left != NULL && __left->__count_ + __x->__count_ < kSlots) {
+        __merge(__parent, __p - 1, __t);
+      } else if (__right != NULL && __x->__count_ + __right->__count_ < kSlots) {
+        __merge(__parent, __p, __t);
+      } else if (__left != NULL && (__right == NULL || __right->__count_ <= __left->__count_)) {
+        __move_from_left(__x, (__left->__count_ - __x->__count_ + 1) / 2, __t);
+        return;
+      } else {
+        __move_from_right(__x, (__right->__count_ - __x->__count_ + 1) / 2, __t);
+        return;
+      }
+      __x = __parent;
+    }
+    if (__root_->__count_ == 0) {
+      node_pointer __old = __root_;
+      if (__old->__leaf_) {
+        __root_ = NULL;
+        __lmost_ = NULL;
+        __rmost_ = NULL;
+      } else {
+        __root_ = __old->__child(0);
+        __root_->__parent_ = NULL;
+        __root_->__position_ = 0;
+      }
+      __free_node(__old);
+    }
+  }
+
+  // Moves value __p of __parent and all of its child __p + 1 to the end of
+  // its child __p
+
+  void __merge(node_pointer __parent, int __p, iterator& __t) {
+    node_pointer __l = __parent->__child(__p);
+    node_pointer __r = __parent->__child(__p + 1);
+    int __lc = __l->__count_;
+    int __rc = __r->__count_;
+    __relocate(&__parent->__value(__p), 1, &__l->__value(__lc));
+    __relocate(&__r->__value(0), __rc, &__l->__value(__lc + 1));
+    if (!__l->__leaf_) {
+      for (int __j = 0; __j <= __rc; ++__j) {
+        __set_child(__l, __lc + 1 + __j, __r->__child(__j));
+      }
+    }
+    __l->__count_ = static_cast<unsigned short>(__lc + 1 + __rc);
+    __relocate(&__parent->__value(__p + 1), __parent->__count_ - __p - 1, &__parent->__value(__p));
+    for (int __j = __p + 1; __j < __parent->__count_; ++__j) {
+      __set_child(__parent, __j, __parent->__child(__j + 1));
+    }
+    --__parent->__count_;
+    if (__t.__node_ptr_ == __parent && __t.__position_ == __p) {
+      __t = iterator(__l, __lc);
+    } else if (__t.__node_ptr_ == __parent && __p < __t.__position_) {
+      --__t.__position_;
+    } else if (__t.__node_ptr_ == __r) {
+      __t = iterator(__l, __t.__position_ + __lc + 1);
+    }
+    if (__r == __rmost_) {
+      __rmost_ = __l;
+    }
+    __free_node(__r);
+  }
+
+  // Moves __n values into __x from its left sibling, through their separator
+
+  void __move_from_left(node_pointer __x, int __n, iterator& __t) {
+    node_pointer __parent = __x->__parent_;
+    int __p = __x->__position_ - 1;
+    node_pointer __l = __parent->__child(__p);
+    int __lc = __l->__count_;
+    int __xc = __x->__count_;
+    __relocate(&__x->__value(0), __xc, &__x->__value(__n));
+    __relocate(&__parent->__value(__p), 1, &__x->__value(__n - 1));
+    __relocate(&__l->__value(__lc - __n + 1), __n - 1, &__x->__value(0));
+    __relocate(&__l->__value(__lc - __n), 1, &__parent->__value(__p));
+    if (!__x->__leaf_) {
+      for (int __j = __xc; 0 <= __j; --__j) {
+        __set_child(__x, __j + __n, __x->__child(__j));
+      }
+      for (int __j = 0; __j < __n; ++__j) {
+        __set_child(__x, __j, __l->__child(__lc - __n + 1 + __j));
+      }
+    }
+    __x->__count_ = static_cast<unsigned short>(__xc + __n);
+    __l->__count_ = static_cast<unsigned short>(__lc - __n);
+    if (__t.__node_ptr_ == __x) {
+      __t.__position_ += __n;
+    } else if (__t.__node_ptr_ == __parent && __t.__position_ == __p) {
+      __t = iterator(__x, __n - 1);
+    } else if (__t.__node_ptr_ == __l && __lc - __n < __t.__position_) {
+      __t = iterator(__x, __t.__position_ - (__lc - __n) - 1);
+    } else if (__t.__node_ptr_ == __l && __lc - __n == __t.__position_) {
+      __t = iterator(__parent, __p);
+    }
+  }
+
+  // Moves __n values into __x from its right sibling, through their separator
+
+  void __move_from_right(node_pointer __x, int __n, iterator& __t) {
+    node_pointer __parent = __x->__parent_;
+    int __p = __x->__position_;
+    node_pointer __r = __parent->__child(__p + 1);
+    int __rc = __r->__count_;
+    int __xc = __x->__count_;
+    __relocate(&__parent->__value(__p), 1, &__x->__value(__xc));
+    __relocate(&__r->__value(0), __n - 1, &__x->__value(__xc + 1));
+    __relocate(&__r->__value(__n - 1), 1, &__parent->__value(__p));
+    __relocate(&__r->__value(__n), __rc - __n, &__r->__value(0));
+    if (!__x->__leaf_) {
+      for (int __j = 0; __j < __n; ++__j) {
+        __set_child(__x, __xc + 1 + __j, __r->__child(__j));
+      }
+      for (int __j = 0; __j <= __rc - __n; ++__j) {
+        __set_child(__r, __j, __r->__child(__j + __n));
+      }
+    }
+    __x->__count_ = static_cast<unsigned short>(__xc + __n);
+    __r->__count_ = static_cast<unsigned short>(__rc - __n);
+    if (__t.__node_ptr_ == __parent && __t.__position_ == __p) {
+      __t = iterator(__x, __xc);
+    } else if (__t.__node_ptr_ == __r && __t.__position_ < __n - 1) {
+      __t = iterator(__x, __xc + 1 + __t.__position_);
+    } else if (__t.__node_ptr_ == __r && __t.__position_ == __n - 1) {
+      __t = iterator(__parent, __p);
+    } else if (__t.__node_ptr_ == __r) {
+      __t.__position_ -= __n;
+    }
+  }
+
+  // The value at __t, or the first one after it if __t is past its node
+
+  iterator __first_from(iterator __t) {
+    node_pointer __x = __t.base();
+    int __i = __t.position();
+    while (__i == __x->__count_ && __x->__parent_ != NULL) {
+      __i = __x->__position_;
+      __x = __x->__parent_;
+    }
+    return __i == __x->__count_ ? end() : iterator(__x, __i);
+  }
+
+  void __erase_n(iterator __first, size_type __n) {
+    for (; __n != 0; --__n) {
+      __first = erase(__first);
+    }
+  }
+
+  // Copy helpers
+
+  void __copy(const tree& __t) {
+    if (__t.__root_ == NULL) {
+      return;
+    }
+    __root_ = __clone(__t.__root_, NULL, 0);
+    __lmost_ = __root_;
+    while (!__lmost_->__leaf_) {
+      __lmost_ = __lmost_->__child(0);
+    }
+    __rmost_ = __root_;
+    while (!__rmost_->__leaf_) {
+      __rmost_ = __rmost_->__child(__rmost_->__count_);
+    }
+    __size_ = __t.__size_;
+  }
+
+  // Copies the subtree of __s with the same shape
+
+  node_pointer __clone(node_pointer __s, node_pointer __parent, int __position) {
+    node_pointer __x = __s->__leaf_ ? __new_leaf() : __new_internal();
+    __x->__parent_ = __parent;
+    __x->__position_ = static_cast<unsigned short>(__position);
+    try {
+      __construct_copies(&__s->__value(0), __s->__count_, &__x->__value(0));
+    } catch (...) {
+      __free_node(__x);
+      throw;
+    }
+    __x->__count_ = __s->__count_;
+    if (!__x->__leaf_) {
+      int __j = 0;
+      try {
+        for (; __j <= __s->__count_; ++__j) {
+          __x->__child(__j) = __clone(__s->__child(__j), __x, __j);
+        }
+      } catch (...) {
+        while (0 < __j--) {
+          __destroy(__x->__child(__j));
+        }
+        __destroy_values(__x, 0, __x->__count_);
+        __free_node(__x);
+        throw;
+      }
+    }
+    return __x;
+  }
+
+}; // __btree class
+
+// Non-member functions
+
+template <class _BtreeTraits>
+inline void swap(__btree<_BtreeTraits>& __x,
+                 __btree<_BtreeTraits>& __y) {
+  __x.swap(__y);
+}
+
+template <class _BtreeTraits>
+inline bool operator==(const __btree<_BtreeTraits>& __x, const __btree<_BtreeTraits>& __y) {
+  return __x.size() == __y.size() && ft::equal(__x.begin(), __x.end(), __y.begin());
+}
+
+template <class _BtreeTraits>
+inline bool operator!=(const __btree<_BtreeTraits>& __x, const __btree<_BtreeTraits>& __y) {
+  return !(__x == __y);
+}
+
+template <class _BtreeTraits>
+inline bool operator<(const __btree<_BtreeTraits>& __x, const __btree<_BtreeTraits>& __y) {
+  return ft::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end());
+}
+
+template <class _BtreeTraits>
+inline bool operator>(const __btree<_BtreeTraits>& __x, const __btree<_BtreeTraits>& __y) {
+  return __y < __x;
+}
+
+template <class _BtreeTraits>
+inline bool operator<=(const __btree<_BtreeTraits>& __x, const __btree<_BtreeTraits>& __y) {
+  return !(__y < __x);
+}
+
+template <class _BtreeTraits>
+inline bool operator>=(const __btree<_BtreeTraits>& __x, const __btree<_BtreeTraits>& __y) {
+  return !(__x < __y);
+}
+
+}
+
+#endif // __BTREE_HPP
@@ -0,0 +1,235 @@
+#ifndef __BTREE_SEARCH_HPP
+#define __BTREE_SEARCH_HPP
+
+#include <cstddef> // for size_t
+#include <functional> // for less
+#include <limits> // for numeric_limits
+
+#include "type_traits.hpp" // for integral_constant and is_same
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ft {
+
+/*
+** Search inside a B-tree node for arithmetic keys ordered by std::less
+**
+** __btree_search<_Key, _Compare>::value tells whether the keys can be searched
+** this way. If so, __lower(__first, __stride, __n, __k) returns how many of the
+** __n keys, __stride bytes apart from __first, are before __k, and __upper how
+** many are not after it, which are the positions lower_bound and upper_bound
+** look for since the keys are sorted. Other keys and comparators use a binary
+** search (see __btree::__bsearch_lower).
+**
+** Q: Why count instead of a binary search?
+** A: Each step of a binary search over a node is a branch that goes either way
+**    with even odds, so about half of the log2(kSlots) steps are mispredicted.
+**    Counting compares all the keys of the node, but without branches. For
+**    btree_map<uint64_t, T> with an 8-byte T, finds took 25 to 55% less time,
+**    from 1k to 10M keys.
+**
+** Q: What instructions are used?
+** A: Those the compiler is allowed to emit: SSE2 for 32-bit keys, float and
+**    double, AVX2 (-mavx2) for 64-bit keys, which compare 2 to 4 keys at once.
+**    Unsigned keys are compared as signed after flipping their sign bits.
+**    Only the keys of sets are vectorized: those of maps sit between mapped
+**    values, and masking the gaps out made the counts slower than one key at
+**    a time. Vectors made finds in sets of 1k keys about twice as fast, a gain
+**    that fades as cache misses take over in larger sets. SSE4.2 alone, with
+**    two 64-bit keys to a vector, did not help.
+*/
+
+template <class _Key, class _Compare>
+struct __btree_search : public false_type {};
+
+// Kinds of keys, for the vectorized counts
+
+enum {
+  __kOtherKey,
+  __kInt32Key,
+  __kUint32Key,
+  __kInt64Key,
+  __kUint64Key,
+  __kFloatKey,
+  __kDoubleKey
+};
+
+template <class _Key>
+struct __btree_key_kind {
+  typedef std::numeric_limits<_Key> __limits;
+
+  static const int __integer_kind =
+      sizeof(_Key) == 4 ? (__limits::is_signed ? __kInt32Key : __kUint32Key)
+      : sizeof(_Key) == 8 ? (__limits::is_signed ? __kInt64Key : __kUint64Key)
+      : __kOtherKey;
+
+  static const int value =
+      __limits::is_integer ? __integer_kind
+      : is_same<_Key, float>::value ? __kFloatKey
+      : is_same<_Key, double>::value ? __kDoubleKey
+      : __kOtherKey;
+};
+
+// Number of keys before __k, or after it if _After
+
+template <bool _After, class _Key>
+int __count_keys(const char* __p, std::size_t __stride, int __n, const _Key& __k) {
+  int __r = 0;
+  for (int __i = 0; __i < __n; ++__i, __p += __stride) {
+    const _Key& __x = *reinterpret_cast<const _Key*>(__p);
+    __r += _After ? __k < __x : __x < __k;
+  }
+  return __r;
+}
+
+template <bool _After, class _Key, int _Kind>
+int __count_keys(const char* __p, std::size_t __stride, int __n, const _Key& __k,
+                 integral_constant<int, _Kind>) {
+  return __count_keys<_After>(__p, __stride, __n, __k);
+}
+
+#if defined(__SSE2__) && defined(__GNUC__)
+
+// The compares set the lanes of the keys that match to -1, so subtracting
+// them counts the matches of each lane, summed up at the end
+
+inline int __sum_epi32(__m128i __acc) {
+  __acc = _mm_add_epi32(__acc, _mm_shuffle_epi32(__acc, 0x4e));
+  __acc = _mm_add_epi32(__acc, _mm_shuffle_epi32(__acc, 0xb1));
+  return _mm_cvtsi128_si32(__acc);
+}
+
+inline int __sum_epi64(__m128i __acc) {
+  return _mm_cvtsi128_si32(_mm_add_epi64(__acc, _mm_unpackhi_epi64(__acc, __acc)));
+}
+
+// 32-bit integers, four to a vector
+
+template <bool _After, class _Key>
+int __count_epi32(const char* __p, std::size_t __stride, int __n, const _Key& __k,
+                  int __sign) {
+  if (__stride != 4) {
+    return __count_keys<_After>(__p, __stride, __n, __k);
+  }
+  const __m128i __flip = _mm_set1_epi32(__sign);
+  const __m128i __kv = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(__k)), __flip);
+  __m128i __acc = _mm_setzero_si128();
+  int __i = 0;
+  for (; __i + 4 <= __n; __i += 4, __p += 16) {
+    __m128i __x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(__p)), __flip);
+    __m128i __c = _After ? _mm_cmpgt_epi32(__x, __kv) : _mm_cmpgt_epi32(__kv, __x);
+    __acc = _mm_sub_epi32(__acc, __c);
+  }
+  return __sum_epi32(__acc) + __count_keys<_After>(__p, __stride, __n - __i, __k);
+}
+
+template <bool _After, class _Key>
+int __count_keys(const char* __p, std::size_t __stride, int __n, const _Key& __k,
+                 integral_constant<int, __kInt32Key>) {
+  return __count_epi32<_After>(__p, __stride, __n, __k, 0);
+}
+
+template <bool _After, class _Key>
+int __count_keys(const char* __p, std::size_t __stride, int __n, const _Key& __k,
+                 integral_constant<int, __kUint32Key>) {
+  return __count_epi32<_After>(__p, __stride, __n, __k, std::numeric_limits<int>::min());
+}
+
+template <bool _After>
+int __count_keys(const char* __p, std::size_t __stride, int __n, const float& __k,
+                 integral_constant<int, __kFloatKey>) {
+  if (__stride != 4) {
+    return __count_keys<_After>(__p, __stride, __n, __k);
+  }
+  const __m128 __kv = _mm_set1_ps(__k);
+  __m128i __acc = _mm_setzero_si128();
+  int __i = 0;
+  for (; __i + 4 <= __n; __i += 4, __p += 16) {
+    __m128 __x = _mm_loadu_ps(reinterpret_cast<const float*>(__p));
+    __m128 __c = _After ? _mm_cmplt_ps(__kv, __x) : _mm_cmplt_ps(__x, __kv);
+    __acc = _mm_sub_epi32(__acc, _mm_castps_si128(__c));
+  }
+  return __sum_epi32(__acc) + __count_keys<_After>(__p, __stride, __n - __i, __k);
+}
+
+template <bool _After>
+int __count_keys(const char* __p, std::size_t __stride, int __n, const double& __k,
+                 integral_constant<int, __kDoubleKey>) {
+  if (__stride != 8) {
+    return __count_keys<_After>(__p, __stride, __n, __k);
+  }
+  const __m128d __kv = _mm_set1_pd(__k);
+  __m128i __acc = _mm_setzero_si128();
+  int __i = 0;
+  for (; __i + 2 <= __n; __i += 2, __p += 16) {
+    __m128d __x = _mm_loadu_pd(reinterpret_cast<const double*>(__p));
+    __m128d __c = _After ? _mm_cmplt_pd(__kv, __x) : _mm_cmplt_pd(__x, __kv);
+    __acc = _mm_sub_epi64(__acc, _mm_castpd_si128(__c));
+  }
+  return __sum_epi64(__acc) + __count_keys<_After>(__p, __stride, __n - __i, __k);
+}
+
+#endif // __SSE2__
+
+#if defined(__AVX2__) && defined(__GNUC__)
+
+// 64-bit integers, four to a vector; the sign bit mask is shifted into place
+// since C++98 has no 64-bit integer type to spell it with
+
+template <bool _After, class _Key>
+int __count_epi64(const char* __p, std::size_t __stride, int __n, const _Key& __k,
+                  int __flip_sign) {
+  if (__stride != 8) {
+    return __count_keys<_After>(__p, __stride, __n, __k);
+  }
+  const __m256i __flip = _mm256_slli_epi64(_mm256_set1_epi64x(__flip_sign), 63);
+  const __m256i __kv = _mm256_xor_si256(_mm256_set1_epi64x(__k), __flip);
+  __m256i __acc = _mm256_setzero_si256();
+  int __i = 0;
+  for (; __i + 4 <= __n; __i += 4, __p += 32) {
+    __m256i __x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(__p)), __flip);
+    __m256i __c = _After ? _mm256_cmpgt_epi64(__x, __kv) : _mm256_cmpgt_epi64(__kv, __x);
+    __acc = _mm256_sub_epi64(__acc, __c);
+  }
+  const int __r = __sum_epi64(_mm_add_epi64(_mm256_castsi256_si128(__acc),
+                                            _mm256_extracti128_si256(__acc, 1)));
+  return __r + __count_keys<_After>(__p, __stride, __n - __i, __k);
+}
+
+template <bool _After, class _Key>
+int __count_keys(const char* __p, std::size_t __stride, int __n, const _Key& __k,
+                 integral_constant<int, __kInt64Key>) {
+  return __count_epi64<_After>(__p, __stride, __n, __k, 0);
+}
+
+template <bool _After, class _Key>
+int __count_keys(const char* __p, std::size_t __stride, int __n, const _Key& __k,
+                 integral_constant<int, __kUint64Key>) {
+  return __count_epi64<_After>(__p, __stride, __n, __k, 1);
+}
+
+#endif // __AVX2__
+
+template <class _Key>
+struct __btree_search<_Key, std::less<_Key> >
+  : public integral_constant<bool, std::numeric_limits<_Key>::is_specialized> {
+
+  typedef integral_constant<int, __btree_key_kind<_Key>::value> __kind;
+
+  static int __lower(const char* __first, std::size_t __stride, int __n, const _Key& __k) {
+    return __count_keys<false>(__first, __stride, __n, __k, __kind());
+  }
+
+  static int __upper(const char* __first, std::size_t __stride, int __n, const _Key& __k) {
+    return __n - __count_keys<true>(__first, __stride, __n, __k, __kind());
+  }
+};
+
+} // namespace ft
+
+#endif // __BTREE_SEARCH_HPP
@@ -0,0 +1,22 @@
+#ifndef __CONFIG_HPP
+#define __CONFIG_HPP
+
+/*
+** The containers are written for C++98. When compiled as C++11 or later,
+** FT_CXX11 enables move semantics and emplace on top of the C++98 interface,
+** which stays unchanged.
+*/
+
+#if __cplusplus >= 201103L
+#define FT_CXX11 1
+#else
+#define FT_CXX11 0
+#endif
+
+#if FT_CXX11
+#define FT_NOEXCEPT noexcept
+#else
+#define FT_NOEXCEPT throw()
+#endif
+
+#endif // __CONFIG_HPP
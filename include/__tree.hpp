@@ -1,6 +1,8 @@
 #ifndef __TREE_HPP
 #define __TREE_HPP
 
+#include <climits> // for CHAR_BIT
+#include <cstddef> // for size_t
 #include <iterator> // for bidirectional iterator tag
 #include <limits> // for numeric_limits
 #include <algorithm> // for min
@@ -12,46 +14,177 @@
 #include "iterator_traits.hpp"
 #include "algorithm.hpp" // for swap
 #include "type_traits.hpp" // for enable_if and is_integral
+#include "pool_allocator.hpp" // for __select_on_copy
+#include "tree_policy.hpp"
+
+#if FT_CXX11
+#include <utility> // for move, forward
+#endif
 
 namespace ft {
 
 template <class _Key, class _Tp, class _KeyGetter, class _Compare,
-          class _Allocator = std::allocator<_Tp> >
+          class _Allocator = std::allocator<_Tp>, class _TreePolicy = ft::tree_plain>
 struct __tree_traits {
 
-  typedef _Key       key_type;
-  typedef _Tp        value_type;
-  typedef _KeyGetter key_getter;
-  typedef _Compare   key_compare;
-  typedef _Allocator allocator_type;
+  typedef _Key        key_type;
+  typedef _Tp         value_type;
+  typedef _KeyGetter  key_getter;
+  typedef _Compare    key_compare;
+  typedef _Allocator  allocator_type;
+  typedef _TreePolicy tree_policy;
 
 }; // __tree_traits
 
+/*
+** Q: Where are the color and the nil flag?
+** A: In the two low bits of the parent link, which are always zero as nodes
+**    are aligned at least on pointers. Separate char/bool members would be
+**    padded to a whole pointer, so a node is now the value and three links.
+**    Two nodes are nil: __head_, which end() points at, and the nil node
+**    that stands for missing children. Both hold no value.
+**
+** Q: What do the links of a missing child point at?
+** A: At the nil node, unless the tree policy is threaded (see
+**    tree_policy.hpp). Then a missing left child is replaced by a thread to
+**    the previous node in key order and a missing right child by a thread to
+**    the next one, or to the nil node past either end. Threads need no flag:
+**    a link is a child only if the node it points at has this node as parent
+**    and is not nil, which one word of the target tells. Nodes and iterators
+**    test links that way and work the same in both kinds of trees.
+**
+** Q: Where is __head_?
+** A: In the tree itself, so that an empty container allocates nothing and
+**    end() stays the same from construction to destruction, as with std.
+**    The root is the only node linking to it, while the nil node is shared
+**    by all the trees of the same type and never written to, so moving or
+**    swapping trees relinks two roots rather than every leaf.
+*/
+
+// Nodes of counted trees also hold the size of their subtree
+
+template <bool _Counted>
+struct __tree_node_count {
+  std::size_t __count_;
+};
+
+template <>
+struct __tree_node_count<false> {};
+
+// and those of aggregated trees the aggregate of their subtree
+
+template <bool _Aggregated, class _Monoid>
+struct __tree_node_aggregate {
+  typename _Monoid::value_type __aggregate_;
+};
+
+template <class _Monoid>
+struct __tree_node_aggregate<false, _Monoid> {};
+
 template <class _TreeTraits>
-struct __tree_node {
+struct __tree_node
+  : public __tree_node_count<_TreeTraits::tree_policy::counted>,
+    public __tree_node_aggregate<_TreeTraits::tree_policy::aggregated,
+                                 typename _TreeTraits::tree_policy::monoid> {
 
   typedef typename _TreeTraits::allocator_type  allocator_type;
   typedef typename allocator_type::value_type   value_type;
   typedef __tree_node*                          node_pointer;
+  typedef std::size_t                           link_type;
+
+  enum {
+    kColorBit = 1,
+    kNilBit = 2,
+    kFlagBits = kColorBit | kNilBit
+  };
 
   value_type __value_;
-  node_pointer __parent_;
   node_pointer __left_;
   node_pointer __right_;
-  char __color_;
-  bool __isnil_;
+  link_type __parent_link_;
+
+  node_pointer __parent() const {
+    return reinterpret_cast<node_pointer>(__parent_link_ & ~static_cast<link_type>(kFlagBits));
+  }
+
+  void __set_parent(node_pointer __p) {
+    __parent_link_ = reinterpret_cast<link_type>(__p) | (__parent_link_ & kFlagBits);
+  }
+
+  char __color() const { return static_cast<char>(__parent_link_ & kColorBit); }
+
+  void __set_color(char __c) {
+    __parent_link_ = (__parent_link_ & ~static_cast<link_type>(kColorBit)) | static_cast<link_type>(__c);
+  }
+
+  bool __is_nil() const { return (__parent_link_ & kNilBit) != 0; }
+
+  void __set_nil() { __parent_link_ |= kNilBit; }
+
+  // A child link is a thread when the node it points at is nil or is not a
+  // child of this one (see the comment on threads above)
+
+  bool __has_left() const { return __is_child(__left_); }
+
+  bool __has_right() const { return __is_child(__right_); }
+
+  bool __is_child(node_pointer __p) const {
+    return (__p->__parent_link_ & ~static_cast<link_type>(kColorBit))
+           == reinterpret_cast<link_type>(this);
+  }
+
+  // Order statistics, only for counted trees
+
+  std::size_t __left_count() const { return __has_left() ? __left_->__count_ : 0; }
+
+  std::size_t __right_count() const { return __has_right() ? __right_->__count_ : 0; }
+
+  // Position of this node in key order, or the size of the tree for __head_
+
+  std::size_t __index() {
+    if (this->__is_nil()) {
+      node_pointer __r = this->__parent();
+      return __r->__is_nil() ? 0 : __r->__count_;
+    }
+    std::size_t __i = this->__left_count();
+    node_pointer __x = this;
+    for (node_pointer __p = __x->__parent(); !(__p->__is_nil()); __p = __x->__parent()) {
+      if (__x == __p->__right_) {
+        __i += __p->__left_count() + 1;
+      }
+      __x = __p;
+    }
+    return __i;
+  }
 
-  __tree_node()
-    : __value_(), __parent_(NULL), __left_(NULL), __right_(NULL), __color_(), __isnil_(true)
-  {}
+  // Node at position __k in the tree holding this node, or __head_ past the
+  // last one
 
-  __tree_node(const value_type& __value)
-    : __value_(__value), __parent_(NULL), __left_(NULL), __right_(NULL), __color_(), __isnil_(false)
-  {}
+  node_pointer __at(std::size_t __k) {
+    node_pointer __head = this;
+    while (!(__head->__is_nil())) {
+      __head = __head->__parent();
+    }
+    node_pointer __x = __head->__parent();
+    if (__x->__is_nil() || __x->__count_ <= __k) {
+      return __head;
+    }
+    for (;;) {
+      std::size_t __l = __x->__left_count();
+      if (__k < __l) {
+        __x = __x->__left_;
+      } else if (__k == __l) {
+        return __x;
+      } else {
+        __k -= __l + 1;
+        __x = __x->__right_;
+      }
+    }
+  }
 
   node_pointer max_node() {
     node_pointer __p = this;
-    while (!(__p->__right_->__isnil_)) {
+    while (__p->__has_right()) {
       __p = __p->__right_;
     }
     return __p;
@@ -59,23 +192,28 @@ struct __tree_node {
 
   node_pointer min_node() {
     node_pointer __p = this;
-    while (!(__p->__left_->__isnil_)) {
+    while (__p->__has_left()) {
       __p = __p->__left_;
     }
     return __p;
   }
 
+  // Without a right child, a __right_ that is not nil is a thread to the next
+  // node. Otherwise the next node is the first ancestor on the right.
+
   node_pointer next_node() {
-    if (this->__isnil_) {
+    if (this->__is_nil()) {
       return this;
-    } else if (!(this->__right_->__isnil_)) {
+    } else if (this->__has_right()) {
       return this->__right_->min_node();
+    } else if (!(this->__right_->__is_nil())) {
+      return this->__right_;
     } else {
       node_pointer __tmp = this;
-      node_pointer __p = __tmp->__parent_;
-      while (!(__p->__isnil_) && __tmp == __p->__right_) {
+      node_pointer __p = __tmp->__parent();
+      while (!(__p->__is_nil()) && __tmp == __p->__right_) {
         __tmp = __p;
-        __p = __tmp->__parent_;
+        __p = __tmp->__parent();
       }
       return __p;
     }
@@ -86,16 +224,18 @@ struct __tree_node {
   // which is __rmost()
 
   node_pointer prev_node() {
-    if (this->__isnil_) {
+    if (this->__is_nil()) {
       return this->__right_;
-    } else if (!(this->__left_->__isnil_)) {
+    } else if (this->__has_left()) {
       return this->__left_->max_node();
+    } else if (!(this->__left_->__is_nil())) {
+      return this->__left_;
     } else {
       node_pointer __tmp = this;
-      node_pointer __p = __tmp->__parent_;
-      while (!(__p->__isnil_) && __tmp == __p->__left_) {
+      node_pointer __p = __tmp->__parent();
+      while (!(__p->__is_nil()) && __tmp == __p->__left_) {
         __tmp = __p;
-        __p = __tmp->__parent_;
+        __p = __tmp->__parent();
       }
       return __p;
     }
@@ -200,6 +340,9 @@ class __tree_const_iterator {
   __tree_const_iterator(const non_const_iterator& __x)
     : __node_ptr_(__x.base()) {}
 
+  __tree_const_iterator(const __tree_const_iterator& __x)
+    : __node_ptr_(__x.base()) {}
+
   __tree_const_iterator& operator=(const __tree_const_iterator& __x) {
     __node_ptr_ = __x.base();
     return *this;
@@ -259,6 +402,227 @@ bool operator!=(const __tree_iterator<_TreeTraits>& __x,
   return !(__x == __y);
 }
 
+/*
+** ft::distance and ft::advance for iterators of counted trees (see
+** tree_order_statistic), which find positions from subtree sizes instead of
+** stepping. advance still steps for short moves, which take fewer reads than
+** going up to the root and down again.
+*/
+
+template <class _Iter>
+typename _Iter::difference_type __tree_distance(const _Iter& __first, const _Iter& __last) {
+  return static_cast<typename _Iter::difference_type>(__last.base()->__index())
+         - static_cast<typename _Iter::difference_type>(__first.base()->__index());
+}
+
+template <class _Iter>
+void __tree_advance(_Iter& __i, typename _Iter::difference_type __n) {
+  if (-8 <= __n && __n <= 8) {
+    ft::__advance(__i, __n, std::bidirectional_iterator_tag());
+  } else {
+    typename _Iter::node_pointer __p = __i.base();
+    __i = _Iter(__p->__at(static_cast<std::size_t>(
+        static_cast<typename _Iter::difference_type>(__p->__index()) + __n)));
+  }
+}
+
+template <class _TreeTraits>
+typename ft::enable_if<_TreeTraits::tree_policy::counted,
+                       typename __tree_iterator<_TreeTraits>::difference_type>::type
+distance(__tree_iterator<_TreeTraits> __first, __tree_iterator<_TreeTraits> __last) {
+  return ft::__tree_distance(__first, __last);
+}
+
+template <class _TreeTraits>
+typename ft::enable_if<_TreeTraits::tree_policy::counted,
+                       typename __tree_const_iterator<_TreeTraits>::difference_type>::type
+distance(__tree_const_iterator<_TreeTraits> __first, __tree_const_iterator<_TreeTraits> __last) {
+  return ft::__tree_distance(__first, __last);
+}
+
+template <class _TreeTraits>
+typename ft::enable_if<_TreeTraits::tree_policy::counted>::type
+advance(__tree_iterator<_TreeTraits>& __i,
+        typename __tree_iterator<_TreeTraits>::difference_type __n) {
+  ft::__tree_advance(__i, __n);
+}
+
+template <class _TreeTraits>
+typename ft::enable_if<_TreeTraits::tree_policy::counted>::type
+advance(__tree_const_iterator<_TreeTraits>& __i,
+        typename __tree_const_iterator<_TreeTraits>::difference_type __n) {
+  ft::__tree_advance(__i, __n);
+}
+
+/*
+** Reverse iterators of trees hold the node they point at, not their base
+**
+** Q: Why not the generic ft::reverse_iterator?
+** A: It holds the base and looks for the node before it on every operator*,
+**    so reading it->first and then it->second walked the tree twice. Nodes do
+**    not move, so the node itself is kept and each step or access costs at
+**    most one walk. base() is found from it, as the node after, or begin()
+**    for rend(), whose node is __head_.
+**
+** Q: What changes?
+** A: An insertion between the node and its base leaves the iterator on its
+**    node, whose base becomes the new node, where the generic one would move
+**    onto the new node. *it is still the value before it.base() either way.
+**    Erasing the value an iterator points at invalidates it, so a loop
+**    erasing backwards takes base() before erasing --base().
+*/
+
+struct __tree_node_tag {};
+
+template <class _Iter, class _Self>
+class __tree_reverse_iterator {
+ public:
+  typedef _Iter                                        iterator_type;
+  typedef typename _Iter::iterator_category            iterator_category;
+  typedef typename _Iter::value_type                   value_type;
+  typedef typename _Iter::difference_type              difference_type;
+  typedef typename _Iter::reference                    reference;
+  typedef typename _Iter::pointer                      pointer;
+  typedef typename _Iter::node_pointer                 node_pointer;
+
+ protected:
+  node_pointer __node_ptr_;
+
+  __tree_reverse_iterator() : __node_ptr_(NULL) {}
+
+  explicit __tree_reverse_iterator(node_pointer __p) : __node_ptr_(__p) {}
+
+  static node_pointer __next(node_pointer __p) {
+    return __p->__is_nil() ? __p->__left_ : __p->next_node();
+  }
+
+ public:
+  iterator_type base() const { return iterator_type(__next(__node_ptr_)); }
+
+  reference operator*() const { return __node_ptr_->__value_; }
+
+  pointer operator->() const { return &**this; }
+
+  _Self& operator++() {
+    __node_ptr_ = __node_ptr_->prev_node();
+    return static_cast<_Self&>(*this);
+  }
+
+  _Self operator++(int) {
+    _Self __tmp = static_cast<_Self&>(*this);
+    ++*this;
+    return __tmp;
+  }
+
+  _Self& operator--() {
+    __node_ptr_ = __next(__node_ptr_);
+    return static_cast<_Self&>(*this);
+  }
+
+  _Self operator--(int) {
+    _Self __tmp = static_cast<_Self&>(*this);
+    --*this;
+    return __tmp;
+  }
+
+  node_pointer __node() const { return __node_ptr_; }
+
+}; // __tree_reverse_iterator
+
+template <class _TreeTraits>
+class reverse_iterator<__tree_iterator<_TreeTraits> >
+  : public __tree_reverse_iterator<__tree_iterator<_TreeTraits>,
+                                   reverse_iterator<__tree_iterator<_TreeTraits> > > {
+  typedef __tree_reverse_iterator<__tree_iterator<_TreeTraits>, reverse_iterator> __base;
+
+ public:
+  typedef typename __base::iterator_type               iterator_type;
+  typedef typename __base::node_pointer                node_pointer;
+
+  reverse_iterator() : __base() {}
+
+  explicit reverse_iterator(iterator_type __it) : __base(__it.base()->prev_node()) {}
+
+  // Used by __tree, which has the node at hand
+
+  reverse_iterator(node_pointer __p, __tree_node_tag) : __base(__p) {}
+
+}; // reverse_iterator<__tree_iterator>
+
+template <class _TreeTraits>
+class reverse_iterator<__tree_const_iterator<_TreeTraits> >
+  : public __tree_reverse_iterator<__tree_const_iterator<_TreeTraits>,
+                                   reverse_iterator<__tree_const_iterator<_TreeTraits> > > {
+  typedef __tree_reverse_iterator<__tree_const_iterator<_TreeTraits>, reverse_iterator> __base;
+
+ public:
+  typedef typename __base::iterator_type               iterator_type;
+  typedef typename __base::node_pointer                node_pointer;
+
+  reverse_iterator() : __base() {}
+
+  explicit reverse_iterator(iterator_type __it) : __base(__it.base()->prev_node()) {}
+
+  reverse_iterator(node_pointer __p, __tree_node_tag) : __base(__p) {}
+
+  // To enable a conversion from non-const iterator to const iterator
+
+  reverse_iterator(const reverse_iterator<__tree_iterator<_TreeTraits> >& __x)
+    : __base(__x.__node()) {}
+
+}; // reverse_iterator<__tree_const_iterator>
+
+// Tree reverse iterators compare their nodes rather than their bases, in any
+// mix of const and non-const
+
+template <class _TreeTraits>
+bool operator==(const reverse_iterator<__tree_iterator<_TreeTraits> >& __x,
+                const reverse_iterator<__tree_iterator<_TreeTraits> >& __y) {
+  return __x.__node() == __y.__node();
+}
+
+template <class _TreeTraits>
+bool operator==(const reverse_iterator<__tree_const_iterator<_TreeTraits> >& __x,
+                const reverse_iterator<__tree_const_iterator<_TreeTraits> >& __y) {
+  return __x.__node() == __y.__node();
+}
+
+template <class _TreeTraits>
+bool operator==(const reverse_iterator<__tree_iterator<_TreeTraits> >& __x,
+                const reverse_iterator<__tree_const_iterator<_TreeTraits> >& __y) {
+  return __x.__node() == __y.__node();
+}
+
+template <class _TreeTraits>
+bool operator==(const reverse_iterator<__tree_const_iterator<_TreeTraits> >& __x,
+                const reverse_iterator<__tree_iterator<_TreeTraits> >& __y) {
+  return __x.__node() == __y.__node();
+}
+
+template <class _TreeTraits>
+bool operator!=(const reverse_iterator<__tree_iterator<_TreeTraits> >& __x,
+                const reverse_iterator<__tree_iterator<_TreeTraits> >& __y) {
+  return !(__x == __y);
+}
+
+template <class _TreeTraits>
+bool operator!=(const reverse_iterator<__tree_const_iterator<_TreeTraits> >& __x,
+                const reverse_iterator<__tree_const_iterator<_TreeTraits> >& __y) {
+  return !(__x == __y);
+}
+
+template <class _TreeTraits>
+bool operator!=(const reverse_iterator<__tree_iterator<_TreeTraits> >& __x,
+                const reverse_iterator<__tree_const_iterator<_TreeTraits> >& __y) {
+  return !(__x == __y);
+}
+
+template <class _TreeTraits>
+bool operator!=(const reverse_iterator<__tree_const_iterator<_TreeTraits> >& __x,
+                const reverse_iterator<__tree_iterator<_TreeTraits> >& __y) {
+  return !(__x == __y);
+}
+
 template <class _TreeTraits>
 class __tree {
 
@@ -270,6 +634,9 @@ class __tree {
   typedef typename _TreeTraits::value_type            value_type;
   typedef typename _TreeTraits::allocator_type        allocator_type;
   typedef typename _TreeTraits::key_getter            key_getter;
+  typedef typename _TreeTraits::tree_policy           tree_policy;
+  typedef typename tree_policy::monoid                monoid;
+  typedef typename monoid::value_type                 aggregate_type;
   typedef typename allocator_type::size_type          size_type;
   typedef typename allocator_type::difference_type    difference_type;
   typedef typename allocator_type::pointer            pointer;
@@ -285,8 +652,7 @@ class __tree {
     node;
   typedef typename allocator_type::template rebind<node>::other::pointer
     node_pointer;
-  typedef typename allocator_type::template rebind<node_pointer>::other::reference
-    node_pointer_reference;
+  typedef node_pointer&                               node_pointer_reference;
 
   typedef ft::pair<iterator, bool>                    pair_ib;
   typedef ft::pair<iterator, iterator>                pair_ii;
@@ -299,14 +665,38 @@ class __tree {
     kBlack // = 1
   };
 
+  // Storage for a node whose value is never constructed
+
+  struct __head_storage {
+    union {
+      char __buf_[sizeof(node)];
+      long double __ld_;
+      void* __p_;
+    } __u_;
+
+    node_pointer __get() { return reinterpret_cast<node_pointer>(__u_.__buf_); }
+
+    __head_storage() {
+      node_pointer __h = __get();
+      __h->__left_ = __h;
+      __h->__right_ = __h;
+      __h->__parent_link_ = 0;
+      __h->__set_parent(__h);
+      __h->__set_color(kBlack);
+      __h->__set_nil();
+    }
+  };
+
   // Member variables
 
+  __head_storage __head_node_;
   node_pointer __head_;
   size_type __size_;
+  node_pointer __spare_;
+  size_type __nspare_;
   key_compare __comp_;
   allocator_type __alloc_value_;
   typename allocator_type::template rebind<node>::other __alloc_node_;
-  typename allocator_type::template rebind<node_pointer>::other __alloc_node_pointer_;
 
   // key_getter is either __identity (for set) or __select_first (for map) defined in type_traits.hpp
 
@@ -317,39 +707,67 @@ class __tree {
  public:
 
   __tree(const key_compare& __comp, const allocator_type& __a)
-    : __comp_(__comp), __alloc_value_(__a), __alloc_node_(__a), __alloc_node_pointer_(__a) {
+    : __comp_(__comp), __alloc_value_(__a), __alloc_node_(__a) {
     __init();
   }
 
   __tree(const value_type *__first, const value_type *__last,
          const key_compare& __comp, const allocator_type& __a)
-    : __comp_(__comp), __alloc_value_(__a), __alloc_node_(__a), __alloc_node_pointer_(__a) {
+    : __comp_(__comp), __alloc_value_(__a), __alloc_node_(__a) {
     __init();
     insert(__first, __last);
   }
 
   __tree(const tree& __t)
-    : __comp_(__t.key_comp()), __alloc_value_(__t.get_allocator()),
-      __alloc_node_(__t.get_allocator()), __alloc_node_pointer_(__t.get_allocator()) {
+    : __comp_(__t.key_comp()), __alloc_value_(ft::__select_on_copy(__t.__alloc_value_)),
+      __alloc_node_(__alloc_value_) {
     __init();
     __copy(__t);
   }
 
+#if FT_CXX11
+  __tree(tree&& __t)
+    : __comp_(__t.key_comp()), __alloc_value_(__t.get_allocator()),
+      __alloc_node_(__t.get_allocator()) {
+    __init();
+    swap(__t);
+  }
+#endif
+
   ~__tree() {
     erase(begin(), end());
-    __destnode(__head_);
+    __free_spares();
     __head_ = NULL;
     __size_ = 0;
   }
 
+  /*
+  ** Q: Why are the nodes recycled?
+  ** A: Containers assigned over and over with contents of a similar size would
+  **    otherwise free every node and allocate them all again. The values are
+  **    destroyed but the nodes are kept aside as spares, from which the copy
+  **    takes its nodes before asking the allocator. Spares left over are freed.
+  */
+
   tree& operator=(const tree& __t) {
     if (this != &__t) {
-      erase(begin(), end());
+      clear_keep_capacity();
       __copy(__t);
+      __free_spares();
     }
     return *this;
   }
 
+#if FT_CXX11
+  tree& operator=(tree&& __t) {
+    if (this != &__t) {
+      clear();
+      swap(__t);
+    }
+    return *this;
+  }
+#endif
+
   iterator begin() { return iterator(__lmost()); }
 
   const_iterator begin() const { return const_iterator(__lmost()); }
@@ -358,16 +776,20 @@ class __tree {
 
   const_iterator end() const { return const_iterator(__head_); }
 
-  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rbegin() { return reverse_iterator(__rmost(), __tree_node_tag()); }
 
-  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(__rmost(), __tree_node_tag()); }
 
-  reverse_iterator rend() { return reverse_iterator(begin()); }
+  reverse_iterator rend() { return reverse_iterator(__head_, __tree_node_tag()); }
 
-  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(__head_, __tree_node_tag()); }
 
   size_type size() const { return __size_; }
 
+  // Nodes held, including spares kept by reserve and clear_keep_capacity
+
+  size_type capacity() const { return __size_ + __nspare_; }
+
   size_type max_size() const {
     return std::min<size_type>(
            __alloc_node_.max_size(),
@@ -376,7 +798,9 @@ class __tree {
 
   bool empty() const { return size() == 0; }
 
-  allocator_type get_allocator() const { return __alloc_value_; }
+  // Built from the node allocator, which is the one holding any allocator state
+
+  allocator_type get_allocator() const { return allocator_type(__alloc_node_); }
 
   key_compare key_comp() const { return __comp_; }
 
@@ -384,27 +808,12 @@ class __tree {
   // Next, check if __v already exists in the tree
 
   pair_ib insert(const value_type& __v) {
-    node_pointer __x = __root();
-    node_pointer __y = __head_;
-    bool __add_left = true;
-    while (!(__x->__isnil_)) {
-      __y = __x;
-      __add_left = __comp_(key_getter()(__v), __key(__x));
-      __x = __add_left ? __x->__left_ : __x->__right_;
-    }
-    iterator __it = iterator(__y);
-    if (!__add_left) {
-      ;
-    } else if (__it == begin()) {
-      return pair_ib(__insert(true, __y, __v), true);
-    } else {
-      --__it;
-    }
-    if (__comp_(__key(__it.base()), key_getter()(__v))) {
-      return pair_ib(__insert(__add_left, __y, __v), true);
-    } else {
-      return pair_ib(__it, false);
+    node_pointer __parent;
+    bool __add_left;
+    if (!__find_position(key_getter()(__v), __parent, __add_left)) {
+      return pair_ib(iterator(__parent), false);
     }
+    return pair_ib(__insert(__add_left, __parent, __v), true);
   }
 
   /*
@@ -413,40 +822,98 @@ class __tree {
   */
 
   iterator insert(iterator __it, const value_type& __v) {
-    if (size() == 0) {
-      return __insert(true, __head_, __v);
-    } else if (__it == begin()) {
-      if (__comp_(key_getter()(__v), __key(__lmost()))) {
-        return __insert(true, __lmost(), __v);
-      }
-    } else if (__it == end()) {
-      if (__comp_(__key(__rmost()), key_getter()(__v))) {
-        return __insert(false, __rmost(), __v);
-      }
-    } else {
-      iterator __it_prev = __it;
-      --__it_prev;
-      if (__comp_(__key(__it_prev.base()), key_getter()(__v))
-          && __comp_(key_getter()(__v), __key(__it.base()))) {
-        if (__it_prev.base()->__right_->__isnil_) {
-          return __insert(false, __it_prev.base(), __v);
-        } else {
-          return __insert(true, __it.base(), __v);
-        }
-      }
+    node_pointer __parent;
+    bool __add_left;
+    if (__find_hint_position(__it, key_getter()(__v), __parent, __add_left)) {
+      return __insert(__add_left, __parent, __v);
     }
     return insert(__v).first;
   }
 
+  /*
+  ** Inserts a value for __k unless the key is already there, finding out with
+  ** the same descent as the insertion. __make(__alloc, __p) constructs the
+  ** value, whose key must be __k, at __p with __alloc, and is only called
+  ** when __k is missing, so nothing is built for a key already in the tree.
+  */
+
+  template <class _Make>
+  pair_ib __emplace_unique_key(const key_type& __k, _Make __make) {
+    node_pointer __parent;
+    bool __add_left;
+    if (!__find_position(__k, __parent, __add_left)) {
+      return pair_ib(iterator(__parent), false);
+    }
+    if (max_size() - 1 <= __size_) {
+      throw std::length_error("map/set<T> too long");
+    }
+    node_pointer __new = __consnode(__parent, kRed);
+    try {
+      __make(__alloc_value_, &(__new->__value_));
+    } catch (...) {
+      __destnode(__new);
+      throw;
+    }
+    return pair_ib(__insert_node(__add_left, __parent, __new), true);
+  }
+
+#if FT_CXX11
+  // The value is built in a new node first, as its key is not known before
+
+  template <class... _Args>
+  pair_ib emplace(_Args&&... __args) {
+    node_pointer __new = __consnode_with(std::forward<_Args>(__args)...);
+    node_pointer __parent;
+    bool __add_left;
+    if (!__find_position(__key(__new), __parent, __add_left)) {
+      __destval(&(__new->__value_));
+      __destnode(__new);
+      return pair_ib(iterator(__parent), false);
+    }
+    return pair_ib(__insert_node(__add_left, __parent, __new), true);
+  }
+
+  template <class... _Args>
+  iterator emplace_hint(iterator __it, _Args&&... __args) {
+    node_pointer __new = __consnode_with(std::forward<_Args>(__args)...);
+    node_pointer __parent;
+    bool __add_left;
+    if (!__find_hint_position(__it, __key(__new), __parent, __add_left)
+        && !__find_position(__key(__new), __parent, __add_left)) {
+      __destval(&(__new->__value_));
+      __destnode(__new);
+      return iterator(__parent);
+    }
+    return __insert_node(__add_left, __parent, __new);
+  }
+#endif
+
+  /*
+  ** Q: Why is the range inspected first?
+  ** A: An empty tree filled from a forward range whose keys are strictly
+  **    increasing, e.g. another map or a sorted vector, is built in O(n) by
+  **    __build_sorted. Checking the keys costs one comparison per element.
+  **    Any other range is inserted before end(), so sorted input with
+  **    duplicates or read through an input iterator still takes the O(1) hint.
+  */
+
   template <class _Iterator>
   void insert(_Iterator __first, _Iterator __last) {
-    for (; __first != __last; ++__first) {
-      insert(*__first);
-    }
+    __insert_range(__first, __last,
+                   typename ft::iterator_traits<_Iterator>::iterator_category());
+  }
+
+  // The caller guarantees that the keys of [__first, __last) are strictly
+  // increasing, so an empty tree is built without checking them
+
+  template <class _Iterator>
+  void insert_sorted_unique(_Iterator __first, _Iterator __last) {
+    __insert_sorted_unique(__first, __last,
+                           typename ft::iterator_traits<_Iterator>::iterator_category());
   }
 
   void erase(iterator __p) {
-    if (__p.base()->__isnil_) {
+    if (__p.base() == __head_) {
       throw std::out_of_range("map/set<T> iterator");
     }
     node_pointer __target = __p.base();
@@ -454,8 +921,10 @@ class __tree {
     node_pointer __replace;
     node_pointer __target_parent;
     __determine_target_n_replace(__target, __replace);
+    __rethread(__target, __node_to_erase);
     __separate_node_to_erase(__target, __node_to_erase, __replace, __target_parent);
-    if (__node_to_erase->__color_ == kBlack) {
+    __update_path(__target_parent);
+    if (__node_to_erase->__color() == kBlack) {
       __update_color(__replace, __target_parent);
     }
     __erase_node(__node_to_erase);
@@ -464,7 +933,7 @@ class __tree {
   void erase(iterator __first, iterator __last) {
     if (size() != 0 && __first == begin() && __last == end()) {
       __erase(__root());
-      __root() = __head_;
+      __set_root(__nil());
       __size_ = 0;
       __lmost() = __head_;
       __rmost() = __head_;
@@ -475,11 +944,15 @@ class __tree {
     }
   }
 
+  // Keys are unique, so at most the node found is erased
+
   size_type erase(const key_type& __x) {
-    pair_ii __range = equal_range(__x);
-    size_type __n = ft::distance(__range.first, __range.second);
-    erase(__range.first, __range.second);
-    return __n;
+    node_pointer __p = __find(__x);
+    if (__p == __head_) {
+      return 0;
+    }
+    erase(iterator(__p));
+    return 1;
   }
 
   void erase(const key_type *__first, const key_type *__last) {
@@ -488,29 +961,41 @@ class __tree {
     }
   }
 
-  void clear() { erase(begin(), end()); }
+  void clear() {
+    erase(begin(), end());
+  }
+
+  // Spare nodes are taken by the next insertions before the allocator is used
 
-  iterator find(const key_type& __k) {
-    iterator __p = lower_bound(__k);
-    return (__p == end() || __comp_(__k, __key(__p.base()))) ? end() : __p;
+  void reserve(size_type __n) {
+    if (max_size() <= __n) {
+      throw std::length_error("map/set<T> too long");
+    }
+    while (capacity() < __n) {
+      __push_spare(__alloc_node_.allocate(1));
+    }
   }
 
-  /*
-  ** If the container is empty, __p is an iterator of __head_ which equals to
-  ** end()
-  ** lower_bound returns an iterator that satisfies __k <= __key(__p.base())
-  ** Therefore, if __comp_(__k, __key(__p.base())) is false, __p's key equals
-  ** to __k
-  */
+  void clear_keep_capacity() {
+    if (size() != 0) {
+      __recycle(__root());
+      __set_root(__nil());
+      __size_ = 0;
+      __lmost() = __head_;
+      __rmost() = __head_;
+    }
+  }
+
+  iterator find(const key_type& __k) {
+    return iterator(__find(__k));
+  }
 
   const_iterator find(const key_type& __k) const {
-    const_iterator __p = lower_bound(__k);
-    return (__p == end() || __comp_(__k, __key(__p.base()))) ? end() : __p;
+    return const_iterator(__find(__k));
   }
 
   size_type count(const key_type& __k) const {
-    pair_cc __ans = equal_range(__k);
-    return ft::distance(__ans.first, __ans.second);
+    return __find(__k) != __head_ ? 1 : 0;
   }
 
   iterator lower_bound(const key_type& __k) {
@@ -529,32 +1014,211 @@ class __tree {
     return const_iterator(__ubound(__k));
   }
 
+  // With unique keys, the range is empty or the lower bound and the node after
+  // it, so a single descent is enough
+
   pair_ii equal_range(const key_type& __k) {
-    return pair_ii(lower_bound(__k), upper_bound(__k));
+    node_pointer __p = __lbound(__k);
+    return pair_ii(iterator(__p), iterator(__is_key_of(__k, __p) ? __p->next_node() : __p));
   }
 
   pair_cc equal_range(const key_type& __k) const {
-    return pair_cc(lower_bound(__k), upper_bound(__k));
+    node_pointer __p = __lbound(__k);
+    return pair_cc(const_iterator(__p),
+                   const_iterator(__is_key_of(__k, __p) ? __p->next_node() : __p));
+  }
+
+  /*
+  ** Lookups by any type _K2 the comparator takes, when it is transparent
+  **
+  ** Q: Why only then?
+  ** A: A comparator that is not transparent may only accept key_type, so the
+  **    key is converted before the lookup as it always was. With one, looking
+  **    up a map<std::string, T> by a const char* compares the characters in
+  **    place instead of building a string for each lookup.
+  **
+  ** Several keys may be equivalent to a _K2 (e.g. all the keys starting with
+  ** a prefix), so count, erase and equal_range work on the whole range.
+  */
+
+  template <class _K2>
+  typename ft::enable_if<__is_transparent<key_compare, _K2>::value, size_type>::type
+  erase(const _K2& __x) {
+    iterator __first(__lbound(__x));
+    iterator __last(__ubound(__x));
+    size_type __n = ft::distance(__first, __last);
+    erase(__first, __last);
+    return __n;
+  }
+
+  template <class _K2>
+  typename ft::enable_if<__is_transparent<key_compare, _K2>::value, iterator>::type
+  find(const _K2& __k) {
+    return iterator(__find(__k));
+  }
+
+  template <class _K2>
+  typename ft::enable_if<__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  find(const _K2& __k) const {
+    return const_iterator(__find(__k));
+  }
+
+  template <class _K2>
+  typename ft::enable_if<__is_transparent<key_compare, _K2>::value, size_type>::type
+  count(const _K2& __k) const {
+    return ft::distance(const_iterator(__lbound(__k)), const_iterator(__ubound(__k)));
+  }
+
+  template <class _K2>
+  typename ft::enable_if<__is_transparent<key_compare, _K2>::value, iterator>::type
+  lower_bound(const _K2& __k) {
+    return iterator(__lbound(__k));
+  }
+
+  template <class _K2>
+  typename ft::enable_if<__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  lower_bound(const _K2& __k) const {
+    return const_iterator(__lbound(__k));
+  }
+
+  template <class _K2>
+  typename ft::enable_if<__is_transparent<key_compare, _K2>::value, iterator>::type
+  upper_bound(const _K2& __k) {
+    return iterator(__ubound(__k));
+  }
+
+  template <class _K2>
+  typename ft::enable_if<__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  upper_bound(const _K2& __k) const {
+    return const_iterator(__ubound(__k));
+  }
+
+  template <class _K2>
+  typename ft::enable_if<__is_transparent<key_compare, _K2>::value, pair_ii>::type
+  equal_range(const _K2& __k) {
+    return pair_ii(iterator(__lbound(__k)), iterator(__ubound(__k)));
+  }
+
+  template <class _K2>
+  typename ft::enable_if<__is_transparent<key_compare, _K2>::value, pair_cc>::type
+  equal_range(const _K2& __k) const {
+    return pair_cc(const_iterator(__lbound(__k)), const_iterator(__ubound(__k)));
+  }
+
+  // Order statistics, only for counted trees (see tree_order_statistic)
+
+  iterator nth(size_type __k) { return iterator(__head_->__at(__k)); }
+
+  const_iterator nth(size_type __k) const { return const_iterator(__head_->__at(__k)); }
+
+  // Number of keys going before __k
+
+  size_type rank(const key_type& __k) const {
+    size_type __r = 0;
+    node_pointer __x = __root();
+    while (!__x->__is_nil()) {
+      if (__comp_(__key(__x), __k)) {
+        __r += __x->__left_count() + 1;
+        __x = __right(__x);
+      } else {
+        __x = __left(__x);
+      }
+    }
+    return __r;
+  }
+
+  // Range aggregates, only for aggregated trees (see tree_aggregate)
+
+  aggregate_type aggregate() const { return __aggregate_of(__root()); }
+
+  /*
+  ** Aggregate of the values whose keys are in [__lo, __hi], i.e. from
+  ** lower_bound(__lo) to upper_bound(__hi), in O(log n)
+  **
+  ** Q: How?
+  ** A: The search for both bounds goes down together until they part at the
+  **    highest node of the range. Below it, the way to __lo takes each node
+  **    not before __lo with its whole right subtree, and the way to __hi each
+  **    node not after __hi with its whole left subtree.
+  */
+
+  aggregate_type aggregate(const key_type& __lo, const key_type& __hi) const {
+    node_pointer __x = __root();
+    while (!__x->__is_nil()) {
+      if (__comp_(__key(__x), __lo)) {
+        __x = __right(__x);
+      } else if (__comp_(__hi, __key(__x))) {
+        __x = __left(__x);
+      } else {
+        break;
+      }
+    }
+    if (__x->__is_nil()) {
+      return monoid::identity();
+    }
+    aggregate_type __l = monoid::identity();
+    for (node_pointer __n = __left(__x); !__n->__is_nil(); ) {
+      if (__comp_(__key(__n), __lo)) {
+        __n = __right(__n);
+      } else {
+        __l = monoid::combine(monoid::combine(__lift(__n), __aggregate_of(__right(__n))), __l);
+        __n = __left(__n);
+      }
+    }
+    aggregate_type __r = monoid::identity();
+    for (node_pointer __n = __right(__x); !__n->__is_nil(); ) {
+      if (__comp_(__hi, __key(__n))) {
+        __n = __left(__n);
+      } else {
+        __r = monoid::combine(__r, monoid::combine(__aggregate_of(__left(__n)), __lift(__n)));
+        __n = __right(__n);
+      }
+    }
+    return monoid::combine(monoid::combine(__l, __lift(__x)), __r);
+  }
+
+  // To call after changing in place the value __p points at
+
+  void refresh(iterator __p) {
+    if (__aggregated::value) {
+      __update_path(__p.base());
+    }
   }
 
+  // The heads stay with their trees, only their links are exchanged
+
   void swap(tree& __x) {
-    ft::swap(__head_, __x.__head_);
+    ft::swap(__head_->__left_, __x.__head_->__left_);
+    ft::swap(__head_->__right_, __x.__head_->__right_);
+    node_pointer __r = __root();
+    __set_root(__x.__root());
+    __x.__set_root(__r);
     ft::swap(__size_, __x.__size_);
+    ft::swap(__spare_, __x.__spare_);
+    ft::swap(__nspare_, __x.__nspare_);
     ft::swap(__comp_, __x.__comp_);
     ft::swap(__alloc_value_, __x.__alloc_value_);
     ft::swap(__alloc_node_, __x.__alloc_node_);
-    ft::swap(__alloc_node_pointer_, __x.__alloc_node_pointer_);
+    __relink_head();
+    __x.__relink_head();
   }
 
  protected:
 
   node_pointer __consnode(node_pointer __parent_ptr, char __c) {
-    node_pointer __s = __alloc_node_.allocate(1);
-    __alloc_node_pointer_.construct(&(__s->__left_));
-    __alloc_node_pointer_.construct(&(__s->__right_));
-    __alloc_node_pointer_.construct(&(__s->__parent_), __parent_ptr);
-    __s->__color_ = __c;
-    __s->__isnil_ = false;
+    node_pointer __s;
+    if (__spare_ != NULL) {
+      __s = __spare_;
+      __spare_ = __s->__right_;
+      --__nspare_;
+    } else {
+      __s = __alloc_node_.allocate(1);
+    }
+    __s->__left_ = NULL;
+    __s->__right_ = NULL;
+    __s->__parent_link_ = 0;
+    __s->__set_parent(__parent_ptr);
+    __s->__set_color(__c);
     return __s;
   }
 
@@ -564,25 +1228,77 @@ class __tree {
 
   void __destval(pointer __p) { __alloc_value_.destroy(__p); }
 
-  void __destnode(node_pointer __s) {
-    __alloc_node_pointer_.destroy(&(__s->__parent_));
-    __alloc_node_pointer_.destroy(&(__s->__right_));
-    __alloc_node_pointer_.destroy(&(__s->__left_));
-    __alloc_node_.deallocate(__s, 1);
+#if FT_CXX11
+  template <class... _Args>
+  node_pointer __consnode_with(_Args&&... __args) {
+    if (max_size() - 1 <= __size_) {
+      throw std::length_error("map/set<T> too long");
+    }
+    node_pointer __new = __consnode(__head_, kRed);
+    try {
+      std::allocator_traits<allocator_type>::construct(__alloc_value_, &(__new->__value_),
+                                                       std::forward<_Args>(__args)...);
+    } catch (...) {
+      __destnode(__new);
+      throw;
+    }
+    return __new;
+  }
+#endif
+
+  void __destnode(node_pointer __s) { __alloc_node_.deallocate(__s, 1); }
+
+  // Spare nodes hold no value and are chained through __right_
+
+  void __push_spare(node_pointer __s) {
+    __s->__right_ = __spare_;
+    __spare_ = __s;
+    ++__nspare_;
   }
 
-  // Initiate __head_ pointer that should be black and nill
-  // At the initialization, root, lmost, rmost should be pointed at __head_
+  void __free_spares() {
+    while (__spare_ != NULL) {
+      node_pointer __s = __spare_;
+      __spare_ = __s->__right_;
+      __destnode(__s);
+    }
+    __nspare_ = 0;
+  }
+
+  // An empty tree has the nil node as root, and its head as lmost and rmost
 
   void __init() {
-    __head_ = __consnode(NULL, kBlack);
-    __head_->__isnil_ = true;
-    __root() = __head_;
-    __lmost() = __head_;
-    __rmost() = __head_;
+    __spare_ = NULL;
+    __nspare_ = 0;
+    __head_ = __head_node_.__get();
+    __head_->__left_ = __head_;
+    __head_->__right_ = __head_;
+    __head_->__parent_link_ = 0;
+    __head_->__set_parent(__nil());
+    __head_->__set_color(kBlack);
+    __head_->__set_nil();
     __size_ = 0;
   }
 
+  // Shared by all the trees of the same type, and never written to after this
+
+  static node_pointer __nil() {
+    static __head_storage __s;
+    return __s.__get();
+  }
+
+  // After the links of two heads were exchanged, the root points back at the
+  // head, or the head of an empty tree at itself
+
+  void __relink_head() {
+    if (__size_ == 0) {
+      __lmost() = __head_;
+      __rmost() = __head_;
+    } else {
+      __root()->__set_parent(__head_);
+    }
+  }
+
   node_pointer& __lmost() { return __head_->__left_; }
 
   node_pointer& __lmost() const { return __head_->__left_; }
@@ -591,9 +1307,108 @@ class __tree {
 
   node_pointer& __rmost() const { return __head_->__right_; }
 
-  node_pointer& __root() { return __head_->__parent_; }
+  node_pointer __root() const { return __head_->__parent(); }
+
+  void __set_root(node_pointer __p) { __head_->__set_parent(__p); }
+
+  // Children of __x, or the nil node in place of a thread. Without threads, the
+  // links are followed as they are.
+
+  node_pointer __left(node_pointer __x) const {
+    return !tree_policy::threaded || __x->__has_left() ? __x->__left_ : __nil();
+  }
+
+  node_pointer __right(node_pointer __x) const {
+    return !tree_policy::threaded || __x->__has_right() ? __x->__right_ : __nil();
+  }
+
+  // What a missing child links to when its neighbour in key order is __x
+
+  node_pointer __thread_to(node_pointer __x) const {
+    return tree_policy::threaded ? __x : __nil();
+  }
+
+  /*
+  ** Node data derived from the subtrees, i.e. the subtree sizes of counted
+  ** trees and the aggregates of aggregated ones, is recomputed bottom-up
+  ** wherever the children of a node change: from a new node or the parent of
+  ** an erased one up to the root, and for both nodes of a rotation. Copies
+  ** keep it as it is.
+  */
+
+  typedef ft::integral_constant<bool, tree_policy::counted> __counted;
+  typedef ft::integral_constant<bool, tree_policy::aggregated> __aggregated;
+  typedef ft::integral_constant<bool, __counted::value || __aggregated::value> __augmented;
+
+  void __update_node(node_pointer __x) {
+    __recount(__x, __counted());
+    __reaggregate(__x, __aggregated());
+  }
+
+  void __update_path(node_pointer __x) {
+    if (__augmented::value) {
+      for (; !__x->__is_nil(); __x = __x->__parent()) {
+        __update_node(__x);
+      }
+    }
+  }
+
+  // __x went down under __y
+
+  void __update_rotated(node_pointer __x, node_pointer __y) {
+    if (__augmented::value) {
+      __update_node(__x);
+      __update_node(__y);
+    }
+  }
+
+  void __copy_augments(node_pointer __y, node_pointer __x) {
+    __copy_count(__y, __x, __counted());
+    __copy_aggregate(__y, __x, __aggregated());
+  }
+
+  void __recount(node_pointer, ft::false_type) {}
+
+  void __recount(node_pointer __x, ft::true_type) {
+    __x->__count_ = 1 + __x->__left_count() + __x->__right_count();
+  }
+
+  void __copy_count(node_pointer, node_pointer, ft::false_type) {}
+
+  void __copy_count(node_pointer __y, node_pointer __x, ft::true_type) {
+    __y->__count_ = __x->__count_;
+  }
+
+  // Values of a set are aggregated as they are, those of a map by mapped value
+
+  template <class _Getter>
+  static aggregate_type __lift_value(const value_type& __v, _Getter) {
+    return aggregate_type(__v);
+  }
+
+  template <class _Pair>
+  static aggregate_type __lift_value(const value_type& __v, ft::__select_first<_Pair>) {
+    return aggregate_type(__v.second);
+  }
+
+  static aggregate_type __lift(node_pointer __x) { return __lift_value(__x->__value_, key_getter()); }
+
+  aggregate_type __aggregate_of(node_pointer __x) const {
+    return __x->__is_nil() ? monoid::identity() : __x->__aggregate_;
+  }
+
+  void __reaggregate(node_pointer, ft::false_type) {}
+
+  void __reaggregate(node_pointer __x, ft::true_type) {
+    __x->__aggregate_ = monoid::combine(monoid::combine(__aggregate_of(__left(__x)), __lift(__x)),
+                                        __aggregate_of(__right(__x)));
+  }
+
+  void __copy_aggregate(node_pointer, node_pointer, ft::false_type) {}
 
-  node_pointer& __root() const { return __head_->__parent_; }
+  void __copy_aggregate(node_pointer __y, node_pointer __x, ft::true_type) {
+    __y->__aggregate_ = __x->__aggregate_;
+  }
 
   /*
   ** Returns a node pointing to the first element in the container whose key
@@ -607,15 +1422,16 @@ class __tree {
   **
   */
 
-  node_pointer __lbound(const key_type& __k) const {
+  template <class _K2>
+  node_pointer __lbound(const _K2& __k) const {
     node_pointer __x = __root();
     node_pointer __y = __head_;
-    while (!(__x->__isnil_)) {
+    while (!__x->__is_nil()) {
       if (__comp_(__key(__x), __k)) {
-        __x = __x->__right_;
+        __x = __right(__x);
       } else {
         __y = __x;
-        __x = __x->__left_;
+        __x = __left(__x);
       }
     }
     return __y;
@@ -632,20 +1448,44 @@ class __tree {
   **             * <- __lbound('c')
   */
 
-  node_pointer __ubound(const key_type& __k) const {
+  template <class _K2>
+  node_pointer __ubound(const _K2& __k) const {
     node_pointer __x = __root();
     node_pointer __y = __head_;
-    while (!(__x->__isnil_)) {
+    while (!__x->__is_nil()) {
       if (__comp_(__k, __key(__x))) {
         __y = __x;
-        __x = __x->__left_;
+        __x = __left(__x);
       } else {
-        __x = __x->__right_;
+        __x = __right(__x);
       }
     }
     return __y;
   }
 
+  /*
+  ** Returns the node whose key is equivalent to __k, or __head_ for end()
+  ** Like __lbound and __ubound, __k is either a key_type or, with a
+  ** transparent comparator, any type the comparator takes
+  **
+  ** Q: Why not stop the descent as soon as the key is met?
+  ** A: That takes two comparisons per level. __lbound takes one, and a last
+  **    one tells whether the node found holds __k, since __k <= its key.
+  */
+
+  template <class _K2>
+  node_pointer __find(const _K2& __k) const {
+    node_pointer __p = __lbound(__k);
+    return __is_key_of(__k, __p) ? __p : __head_;
+  }
+
+  // For a node __p returned by __lbound(__k)
+
+  template <class _K2>
+  bool __is_key_of(const _K2& __k, node_pointer __p) const {
+    return __p != __head_ && !__comp_(__k, __key(__p));
+  }
+
   /*
   **            x                               y
   **           / \      __lrotate(x)           / \
@@ -656,22 +1496,28 @@ class __tree {
   **                                      d   e
   */
 
+  // Without b, __y was the next node after __x, so the right of __x becomes a
+  // thread to __y
+
   void __lrotate(node_pointer __x) {
     node_pointer __y = __x->__right_;
-    __x->__right_ = __y->__left_;
-    if (!(__y->__left_->__isnil_)) {
-      __y->__left_->__parent_ = __x;
+    if (__y->__has_left()) {
+      __x->__right_ = __y->__left_;
+      __y->__left_->__set_parent(__x);
+    } else {
+      __x->__right_ = __thread_to(__y);
     }
-    __y->__parent_ = __x->__parent_;
+    __y->__set_parent(__x->__parent());
     if (__x == __root()) {
-      __root() = __y;
-    } else if (__x == __x->__parent_->__left_) {
-      __x->__parent_->__left_ = __y;
+      __set_root(__y);
+    } else if (__x == __x->__parent()->__left_) {
+      __x->__parent()->__left_ = __y;
     } else {
-      __x->__parent_->__right_ = __y;
+      __x->__parent()->__right_ = __y;
     }
     __y->__left_ = __x;
-    __x->__parent_ = __y;
+    __x->__set_parent(__y);
+    __update_rotated(__x, __y);
   }
 
   /*
@@ -686,103 +1532,397 @@ class __tree {
 
   void __rrotate(node_pointer __x) {
     node_pointer __y = __x->__left_;
-    __x->__left_ = __y->__right_;
-    if (!(__y->__right_->__isnil_)) {
-      __y->__right_->__parent_ = __x;
+    if (__y->__has_right()) {
+      __x->__left_ = __y->__right_;
+      __y->__right_->__set_parent(__x);
+    } else {
+      __x->__left_ = __thread_to(__y);
     }
-    __y->__parent_ = __x->__parent_;
+    __y->__set_parent(__x->__parent());
     if (__x == __root()) {
-      __root() = __y;
-    } else if (__x == __x->__parent_->__right_) {
-      __x->__parent_->__right_ = __y;
+      __set_root(__y);
+    } else if (__x == __x->__parent()->__right_) {
+      __x->__parent()->__right_ = __y;
     } else {
-      __x->__parent_->__left_ = __y;
+      __x->__parent()->__left_ = __y;
     }
     __y->__right_ = __x;
-    __x->__parent_ = __y;
+    __x->__set_parent(__y);
+    __update_rotated(__x, __y);
   }
 
   // The parent node of the root node should be __head_ by definition
   // The root node and __head_ point at each other as their parent nodes
 
   void __copy(const tree& __x) {
-    __root() = __copy(__x.__root(), __head_);
-    __size_ = __x.size();
     __comp_ = __x.__comp_;
-    if (!(__root()->__isnil_)) {
-      __lmost() = __root()->min_node();
-      __rmost() = __root()->max_node();
+    if (__x.size() != 0) {
+      node_pointer __r = __copy(__x.__root());
+      __r->__set_parent(__head_);
+      __set_root(__r);
+      __size_ = __x.size();
+      __lmost() = __r->min_node();
+      __rmost() = __r->max_node();
+    }
+  }
+
+  /*
+  ** Copies the subtree of another tree, keeping its shape and colors, and
+  ** returns the new root with its parent unset
+  **
+  ** Q: How does it work without recursion?
+  ** A: It goes down the left links, copying each node on the way, and keeps
+  **    the right children it passes on a stack with their parents' copies.
+  **    A red-black tree of n nodes is at most 2 * log2(n + 1) high, so the
+  **    stack holds at most twice the number of bits of size_type. Every node
+  **    made so far is reachable from the new root if a copy throws.
+  **    __prev and __next are the copies preceding and following the subtree
+  **    being copied, which its threads point at, or nil without threads.
+  **
+  ** Q: Why in preorder rather than in key order?
+  ** A: Nodes allocated in preorder are mostly next to the one an iterator
+  **    moves to, down a right subtree or up a thread. Allocating in key order
+  **    made a copy of 3M entries about 40% slower to make and to iterate.
+  */
+
+  node_pointer __copy(node_pointer __x) {
+    node_pointer __src[2 * sizeof(size_type) * CHAR_BIT];
+    node_pointer __dst[2 * sizeof(size_type) * CHAR_BIT];
+    node_pointer __succ[2 * sizeof(size_type) * CHAR_BIT];
+    int __top = 0;
+    node_pointer __r = __nil();
+    node_pointer* __link = &__r;
+    node_pointer __parent_ptr = __nil();
+    node_pointer __prev = __nil();
+    node_pointer __next = __nil();
+    try {
+      for (;;) {
+        for (node_pointer __s = __x; ; __s = __s->__left_) {
+          node_pointer __y = __clone(__s, __parent_ptr);
+          *__link = __y;
+          if (__s->__has_right()) {
+            __src[__top] = __s->__right_;
+            __dst[__top] = __y;
+            __succ[__top] = __next;
+            ++__top;
+          } else {
+            __y->__right_ = __next;
+          }
+          if (!__s->__has_left()) {
+            __y->__left_ = __prev;
+            break;
+          }
+          __next = __thread_to(__y);
+          __parent_ptr = __y;
+          __link = &(__y->__left_);
+        }
+        if (__top == 0) {
+          return __r;
+        }
+        --__top;
+        __x = __src[__top];
+        __parent_ptr = __dst[__top];
+        __prev = __thread_to(__parent_ptr);
+        __next = __succ[__top];
+        __link = &(__parent_ptr->__right_);
+      }
+    } catch (...) {
+      __erase(__r);
+      throw;
+    }
+  }
+
+  // A node holding a copy of the value and color of __x, without children
+
+  node_pointer __clone(node_pointer __x, node_pointer __parent_ptr) {
+    node_pointer __y = __consnode(__parent_ptr, __x->__color());
+    try {
+      __consval(&(__y->__value_), __x->__value_);
+    } catch (...) {
+      __destnode(__y);
+      throw;
+    }
+    __y->__left_ = __nil();
+    __y->__right_ = __nil();
+    __copy_augments(__y, __x);
+    return __y;
+  }
+
+  // Helper functions for insert(__first, __last)
+
+  template <class _Iterator>
+  void __insert_hinted(_Iterator __first, _Iterator __last) {
+    for (; __first != __last; ++__first) {
+      insert(end(), *__first);
+    }
+  }
+
+  template <class _Iterator>
+  void __insert_range(_Iterator __first, _Iterator __last, std::input_iterator_tag) {
+    __insert_hinted(__first, __last);
+  }
+
+  template <class _Iterator>
+  void __insert_range(_Iterator __first, _Iterator __last, std::forward_iterator_tag) {
+    size_type __n;
+    if (size() == 0 && __is_strictly_increasing(__first, __last, __n)) {
+      __build_sorted(__first, __n);
     } else {
-      __lmost() = __head_;
-      __rmost() = __head_;
+      __insert_hinted(__first, __last);
+    }
+  }
+
+  template <class _Iterator>
+  void __insert_sorted_unique(_Iterator __first, _Iterator __last, std::input_iterator_tag) {
+    __insert_hinted(__first, __last);
+  }
+
+  template <class _Iterator>
+  void __insert_sorted_unique(_Iterator __first, _Iterator __last, std::forward_iterator_tag) {
+    if (size() == 0) {
+      __build_sorted(__first, static_cast<size_type>(ft::distance(__first, __last)));
+    } else {
+      __insert_hinted(__first, __last);
+    }
+  }
+
+  // Counts the elements in __n as long as each key is less than the next one
+
+  template <class _Iterator>
+  bool __is_strictly_increasing(_Iterator __first, _Iterator __last, size_type& __n) const {
+    __n = 0;
+    if (__first == __last) {
+      return true;
+    }
+    for (_Iterator __prev = __first; ++__first != __last; __prev = __first) {
+      if (!__comp_(key_getter()(*__prev), key_getter()(*__first))) {
+        return false;
+      }
+      ++__n;
+    }
+    ++__n;
+    return true;
+  }
+
+  /*
+  ** Builds the tree of an empty container from __n values whose keys are
+  ** strictly increasing. The middle value of a range becomes the root of its
+  ** subtree, so every level is full except the deepest one, at depth
+  ** floor(log2(__n)). Nodes on that level are red and all the others black,
+  ** which gives every path from the root to a leaf the same number of black
+  ** nodes without a single rotation.
+  **
+  **   {1, 2, 3, 4, 5, 6}          4
+  **                             /   \
+  **                            2     6
+  **                           / \   /
+  **                          1   3 5      <- red
+  */
+
+  template <class _Iterator>
+  void __build_sorted(_Iterator __first, size_type __n) {
+    if (__n == 0) {
+      return;
+    } else if (max_size() <= __n) {
+      throw std::length_error("map/set<T> too long");
     }
+    int __deepest = 0;
+    for (size_type __m = __n; 1 < __m; __m >>= 1) {
+      ++__deepest;
+    }
+    node_pointer __prev = __nil();
+    node_pointer __r = __build_sorted(__first, __n, 0, __deepest, __prev);
+    if (!__prev->__is_nil()) {
+      __prev->__right_ = __nil();
+    }
+    __r->__set_parent(__head_);
+    __set_root(__r);
+    __size_ = __n;
+    __lmost() = __r->min_node();
+    __rmost() = __r->max_node();
   }
 
-  node_pointer __copy(node_pointer __x, node_pointer __parent_ptr) {
-    node_pointer __r = __head_;
-    if (!(__x->__isnil_)) {
-      node_pointer __y = __consnode(__parent_ptr, __x->__color_);
+  // Nodes are created in key order, advancing __first, and the parent link of
+  // the returned subtree is left to the caller. __prev is the node created
+  // last, whose right thread is set once the next node exists, or nil in a
+  // tree without threads.
+
+  template <class _Iterator>
+  node_pointer __build_sorted(_Iterator& __first, size_type __n, int __depth, int __deepest,
+                              node_pointer& __prev) {
+    if (__n == 0) {
+      return __nil();
+    }
+    size_type __nleft = __n / 2;
+    node_pointer __left = __build_sorted(__first, __nleft, __depth + 1, __deepest, __prev);
+    node_pointer __x;
+    try {
+      __x = __consnode(__head_, (__depth == __deepest && __depth != 0) ? kRed : kBlack);
       try {
-        __consval(&(__y->__value_), __x->__value_);
+        __consval(&(__x->__value_), *__first);
       } catch (...) {
-        __destnode(__y);
-        __erase(__r);
+        __destnode(__x);
         throw;
       }
-      __y->__left_ = __head_;
-      __y->__right_ = __head_;
-      if (__r->__isnil_) {
-        __r = __y;
+    } catch (...) {
+      __erase(__left);
+      throw;
+    }
+    __x->__right_ = __nil();
+    if (!__left->__is_nil()) {
+      __x->__left_ = __left;
+      __left->__set_parent(__x);
+      if (!__prev->__is_nil()) {
+        __prev->__right_ = __x;
       }
-      try {
-        __y->__left_ = __copy(__x->__left_, __y);
-        __y->__right_ = __copy(__x->__right_, __y);
-      } catch (...) {
-        __erase(__r);
-        throw;
+    } else {
+      __x->__left_ = __prev;
+    }
+    __prev = __thread_to(__x);
+    try {
+      ++__first;
+      node_pointer __right = __build_sorted(__first, __n - __nleft - 1, __depth + 1, __deepest, __prev);
+      if (!__right->__is_nil()) {
+        __x->__right_ = __right;
+        __right->__set_parent(__x);
       }
+    } catch (...) {
+      __erase(__x);
+      throw;
     }
-    return __r;
+    __update_node(__x);
+    return __x;
   }
 
+  // Children go before their parent, as the threads below a node point at its
+  // ancestors, which must still be there to tell threads from children
+
   void __erase(node_pointer __x) {
-    for (node_pointer __y = __x; !(__y->__isnil_); __x = __y) {
-      __erase(__y->__right_);
-      __y = __y->__left_;
+    if (!__x->__is_nil()) {
+      node_pointer __l = __left(__x);
+      node_pointer __r = __right(__x);
+      __erase(__l);
+      __erase(__r);
       __destval(&(__x->__value_));
       __destnode(__x);
     }
   }
 
+  // Same as __erase but keeps the nodes as spares
+
+  void __recycle(node_pointer __x) {
+    if (!__x->__is_nil()) {
+      node_pointer __l = __left(__x);
+      node_pointer __r = __right(__x);
+      __recycle(__l);
+      __recycle(__r);
+      __destval(&(__x->__value_));
+      __push_spare(__x);
+    }
+  }
+
+  /*
+  ** Finds the node under which a value with key __k should be attached
+  ** Returns false if __k already exists, in which case __parent is set to the
+  ** node holding it
+  */
+
+  bool __find_position(const key_type& __k, node_pointer& __parent, bool& __add_left) {
+    node_pointer __x = __root();
+    __parent = __head_;
+    __add_left = true;
+    while (!__x->__is_nil()) {
+      __parent = __x;
+      __add_left = __comp_(__k, __key(__x));
+      __x = __add_left ? __left(__x) : __right(__x);
+    }
+    iterator __it = iterator(__parent);
+    if (!__add_left) {
+      ;
+    } else if (__it == begin()) {
+      return true;
+    } else {
+      --__it;
+    }
+    if (__comp_(__key(__it.base()), __k)) {
+      return true;
+    }
+    __parent = __it.base();
+    return false;
+  }
+
+  // Same as __find_position but only looks right before __it
+  // Returns false if the hint is not usable
+
+  bool __find_hint_position(iterator __it, const key_type& __k,
+                            node_pointer& __parent, bool& __add_left) {
+    if (size() == 0) {
+      __parent = __head_;
+      __add_left = true;
+      return true;
+    } else if (__it == begin()) {
+      __parent = __lmost();
+      __add_left = true;
+      return __comp_(__k, __key(__lmost()));
+    } else if (__it == end()) {
+      __parent = __rmost();
+      __add_left = false;
+      return __comp_(__key(__rmost()), __k);
+    }
+    iterator __it_prev = __it;
+    --__it_prev;
+    if (__comp_(__key(__it_prev.base()), __k) && __comp_(__k, __key(__it.base()))) {
+      __add_left = __it_prev.base()->__has_right();
+      __parent = __add_left ? __it.base() : __it_prev.base();
+      return true;
+    }
+    return false;
+  }
+
   iterator __insert(bool __addleft, node_pointer __parent, const value_type& __v) {
     if (max_size() - 1 <= __size_) {
       throw std::length_error("map/set<T> too long");
     }
     node_pointer __new = __consnode(__parent, kRed);
-    __new->__left_ = __head_;
-    __new->__right_ = __head_;
     try {
       __consval(&(__new->__value_), __v);
     } catch (...) {
       __destnode(__new);
       throw;
     }
+    return __insert_node(__addleft, __parent, __new);
+  }
+
+  // Links a node holding a value under __parent and rebalances the tree
+  // The new node takes over the thread of __parent on its side and threads
+  // back to __parent on the other one
+
+  iterator __insert_node(bool __addleft, node_pointer __parent, node_pointer __new) {
+    __new->__set_parent(__parent);
+    __new->__set_color(kRed);
     ++__size_;
     if (__parent == __head_) {
-      __root() = __new;
+      __new->__left_ = __nil();
+      __new->__right_ = __nil();
+      __set_root(__new);
       __lmost() = __new;
       __rmost() = __new;
     } else if (__addleft) {
+      __new->__left_ = __parent->__left_;
+      __new->__right_ = __thread_to(__parent);
       __parent->__left_ = __new;
       if (__parent == __lmost()) {
         __lmost() = __new;
       }
     } else {
+      __new->__left_ = __thread_to(__parent);
+      __new->__right_ = __parent->__right_;
       __parent->__right_ = __new;
       if (__parent == __rmost()) {
         __rmost() = __new;
       }
     }
+    __update_path(__new);
     __adjust_color(__new);
     return iterator(__new);
   }
@@ -790,49 +1930,49 @@ class __tree {
   // Helper functions for __insert
 
   void __adjust_color(node_pointer __new) {
-    for (node_pointer __x = __new; __x->__parent_->__color_ == kRed; ) {
-      if (__x->__parent_ == __x->__parent_->__parent_->__left_) {
+    for (node_pointer __x = __new; __x->__parent()->__color() == kRed; ) {
+      if (__x->__parent() == __x->__parent()->__parent()->__left_) {
         __handle_left_parent_case(__x);
       } else {
         __handle_right_parent_case(__x);
       }
     }
-    __root()->__color_ = kBlack;
+    __root()->__set_color(kBlack);
   }
 
-  void __handle_left_parent_case(node_pointer __x) {
-    node_pointer_reference __uncle = __x->__parent_->__parent_->__right_;
-    if (__uncle->__color_ == kRed) {
-      __x->__parent_->__color_ = kBlack;
-      __uncle->__color_ = kBlack;
-      __x->__parent_->__parent_->__color_ = kRed;
-      __x = __x->__parent_->__parent_;
+  void __handle_left_parent_case(node_pointer& __x) {
+    node_pointer __uncle = __right(__x->__parent()->__parent());
+    if (__uncle->__color() == kRed) {
+      __x->__parent()->__set_color(kBlack);
+      __uncle->__set_color(kBlack);
+      __x->__parent()->__parent()->__set_color(kRed);
+      __x = __x->__parent()->__parent();
     } else {
-      if (__x == __x->__parent_->__right_) {
-        __x = __x->__parent_;
+      if (__x == __x->__parent()->__right_) {
+        __x = __x->__parent();
         __lrotate(__x);
       }
-      __x->__parent_->__color_ = kBlack;
-      __x->__parent_->__parent_->__color_ = kRed;
-      __rrotate(__x->__parent_->__parent_);
+      __x->__parent()->__set_color(kBlack);
+      __x->__parent()->__parent()->__set_color(kRed);
+      __rrotate(__x->__parent()->__parent());
     }
   }
 
-  void __handle_right_parent_case(node_pointer __x) {
-    node_pointer_reference __uncle = __x->__parent_->__parent_->__left_;
-    if (__uncle->__color_ == kRed) {
-      __x->__parent_->__color_ = kBlack;
-      __uncle->__color_ = kBlack;
-      __x->__parent_->__parent_->__color_ = kRed;
-      __x = __x->__parent_->__parent_;
+  void __handle_right_parent_case(node_pointer& __x) {
+    node_pointer __uncle = __left(__x->__parent()->__parent());
+    if (__uncle->__color() == kRed) {
+      __x->__parent()->__set_color(kBlack);
+      __uncle->__set_color(kBlack);
+      __x->__parent()->__parent()->__set_color(kRed);
+      __x = __x->__parent()->__parent();
     } else {
-      if (__x == __x->__parent_->__left_) {
-        __x = __x->__parent_;
+      if (__x == __x->__parent()->__left_) {
+        __x = __x->__parent();
         __rrotate(__x);
       }
-      __x->__parent_->__color_ = kBlack;
-      __x->__parent_->__parent_->__color_ = kRed;
-      __lrotate(__x->__parent_->__parent_);
+      __x->__parent()->__set_color(kBlack);
+      __x->__parent()->__parent()->__set_color(kRed);
+      __lrotate(__x->__parent()->__parent());
     }
   }
 
@@ -840,13 +1980,29 @@ class __tree {
 
   void __determine_target_n_replace(node_pointer_reference __target,
                                     node_pointer_reference __replace) {
-    if (__target->__left_->__isnil_) {
-      __replace = __target->__right_;
-    } else if (__target->__right_->__isnil_) {
+    if (!__target->__has_left()) {
+      __replace = __right(__target);
+    } else if (!__target->__has_right()) {
       __replace = __target->__left_;
     } else {
       __target = __target->__right_->min_node();
-      __replace = __target->__right_;
+      __replace = __right(__target);
+    }
+  }
+
+  // The threads pointing at __node_to_erase are moved to the node taking its
+  // place, or to the node it was pointing at itself
+
+  void __rethread(const node_pointer_reference __target,
+                  const node_pointer_reference __node_to_erase) {
+    if (!tree_policy::threaded) {
+      return;
+    } else if (__node_to_erase->__has_left()) {
+      node_pointer __prev = __node_to_erase->__left_->max_node();
+      __prev->__right_ = __has_two_ophans(__target, __node_to_erase)
+                         ? __target : __node_to_erase->__right_;
+    } else if (__node_to_erase->__has_right()) {
+      __node_to_erase->__right_->min_node()->__left_ = __node_to_erase->__left_;
     }
   }
 
@@ -858,15 +2014,15 @@ class __tree {
   void __connect_replace_n_parent(const node_pointer_reference __replace,
                                   const node_pointer_reference __node_to_erase,
                                   const node_pointer_reference __target_parent) {
-    if (!(__replace->__isnil_)) {
-      __replace->__parent_ = __target_parent;
+    if (!__replace->__is_nil()) {
+      __replace->__set_parent(__target_parent);
     }
     if (__root() == __node_to_erase) {
-      __root() = __replace;
+      __set_root(__replace);
     } else if (__target_parent->__left_ == __node_to_erase) {
-      __target_parent->__left_ = __replace;
+      __target_parent->__left_ = !__replace->__is_nil() ? __replace : __node_to_erase->__left_;
     } else {
-      __target_parent->__right_ = __replace;
+      __target_parent->__right_ = !__replace->__is_nil() ? __replace : __node_to_erase->__right_;
     }
   }
 
@@ -875,14 +2031,14 @@ class __tree {
                               const node_pointer_reference __target_parent) {
     if (__lmost() != __node_to_erase) {
       ;
-    } else if (__replace->__isnil_) {
+    } else if (__replace->__is_nil()) {
       __lmost() = __target_parent;
     } else {
       __lmost() = __replace->min_node();
     }
     if (__rmost() != __node_to_erase) {
       ;
-    } else if (__replace->__isnil_) {
+    } else if (__replace->__is_nil()) {
       __rmost() = __target_parent;
     } else {
       __rmost() = __replace->max_node();
@@ -891,34 +2047,39 @@ class __tree {
 
   void __set_target_left(const node_pointer_reference __target,
                          const node_pointer_reference __node_to_erase) {
-    __node_to_erase->__left_->__parent_ = __target;
+    __node_to_erase->__left_->__set_parent(__target);
     __target->__left_ = __node_to_erase->__left_;
   }
 
+  // Without __replace, the node before __target_parent will be __target
+
   void __connect_replace_w_parent(const node_pointer_reference __replace,
+                                  const node_pointer_reference __target,
                                   const node_pointer_reference __target_parent) {
-    if (!(__replace->__isnil_)) {
-      __replace->__parent_ = __target_parent;
+    if (!__replace->__is_nil()) {
+      __replace->__set_parent(__target_parent);
+      __target_parent->__left_ = __replace;
+    } else {
+      __target_parent->__left_ = __thread_to(__target);
     }
-    __target_parent->__left_ = __replace;
   }
 
   void __set_target_right(const node_pointer_reference __target,
                           const node_pointer_reference __node_to_erase) {
     __target->__right_ = __node_to_erase->__right_;
-    __node_to_erase->__right_->__parent_ = __target;
+    __node_to_erase->__right_->__set_parent(__target);
   }
 
   void __set_target_parent(const node_pointer_reference __target,
                            const node_pointer_reference __node_to_erase) {
     if (__root() == __node_to_erase) {
-      __root() = __target;
-    } else if (__node_to_erase->__parent_->__left_ == __node_to_erase) {
-      __node_to_erase->__parent_->__left_ = __target;
+      __set_root(__target);
+    } else if (__node_to_erase->__parent()->__left_ == __node_to_erase) {
+      __node_to_erase->__parent()->__left_ = __target;
     } else {
-      __node_to_erase->__parent_->__right_ = __target;
+      __node_to_erase->__parent()->__right_ = __target;
     }
-    __target->__parent_ = __node_to_erase->__parent_;
+    __target->__set_parent(__node_to_erase->__parent());
   }
 
   /*
@@ -936,14 +2097,16 @@ class __tree {
       if (__target == __node_to_erase->__right_) {
         __target_parent = __target;
       } else {
-        __target_parent = __target->__parent_;
-        __connect_replace_w_parent(__replace, __target_parent);
+        __target_parent = __target->__parent();
+        __connect_replace_w_parent(__replace, __target, __target_parent);
         __set_target_right(__target, __node_to_erase);
       }
       __set_target_parent(__target, __node_to_erase);
-      ft::swap(__target->__color_, __node_to_erase->__color_);
+      char __c = __target->__color();
+      __target->__set_color(__node_to_erase->__color());
+      __node_to_erase->__set_color(__c);
     } else {
-      __target_parent = __node_to_erase->__parent_;
+      __target_parent = __node_to_erase->__parent();
       __connect_replace_n_parent(__replace, __node_to_erase, __target_parent);
       __update_lmost_n_rmost(__replace, __node_to_erase, __target_parent);
     }
@@ -951,28 +2114,28 @@ class __tree {
 
   bool __handle_left_case(node_pointer_reference __replace,
                           node_pointer_reference __target_parent) {
-    node_pointer __replace_sib = __target_parent->__right_;
-    if (__replace_sib->__color_ == kRed) {
-      __replace_sib->__color_ = kBlack;
-      __target_parent->__color_ = kRed;
+    node_pointer __replace_sib = __right(__target_parent);
+    if (__replace_sib->__color() == kRed) {
+      __replace_sib->__set_color(kBlack);
+      __target_parent->__set_color(kRed);
       __lrotate(__target_parent);
-      __replace_sib = __target_parent->__right_;
+      __replace_sib = __right(__target_parent);
     }
-    if (__replace_sib->__isnil_) {
+    if (__replace_sib->__is_nil()) {
       __replace = __target_parent;
-    } else if (__replace_sib->__left_->__color_ == kBlack && __replace_sib->__right_->__color_ == kBlack) {
-      __replace_sib->__color_ = kRed;
+    } else if (__left(__replace_sib)->__color() == kBlack && __right(__replace_sib)->__color() == kBlack) {
+      __replace_sib->__set_color(kRed);
       __replace = __target_parent;
     } else {
-      if (__replace_sib->__right_->__color_ == kBlack) {
-        __replace_sib->__left_->__color_ = kBlack;
-        __replace_sib->__color_ = kRed;
+      if (__right(__replace_sib)->__color() == kBlack) {
+        __left(__replace_sib)->__set_color(kBlack);
+        __replace_sib->__set_color(kRed);
         __rrotate(__replace_sib);
-        __replace_sib = __target_parent->__right_;
+        __replace_sib = __right(__target_parent);
       }
-      __replace_sib->__color_ = __target_parent->__color_;
-      __target_parent->__color_ = kBlack;
-      __replace_sib->__right_->__color_ = kBlack;
+      __replace_sib->__set_color(__target_parent->__color());
+      __target_parent->__set_color(kBlack);
+      __right(__replace_sib)->__set_color(kBlack);
       __lrotate(__target_parent);
       return true;
     }
@@ -981,28 +2144,28 @@ class __tree {
 
   bool __handle_right_case(node_pointer_reference __replace,
                            node_pointer_reference __target_parent) {
-    node_pointer __replace_sib = __target_parent->__left_;
-    if (__replace_sib->__color_ == kRed) {
-      __replace_sib->__color_ = kBlack;
-      __target_parent->__color_ = kRed;
+    node_pointer __replace_sib = __left(__target_parent);
+    if (__replace_sib->__color() == kRed) {
+      __replace_sib->__set_color(kBlack);
+      __target_parent->__set_color(kRed);
       __rrotate(__target_parent);
-      __replace_sib = __target_parent->__left_;
+      __replace_sib = __left(__target_parent);
     }
-    if (__replace_sib->__isnil_) {
+    if (__replace_sib->__is_nil()) {
       __replace = __target_parent; // should not happen
-    } else if (__replace_sib->__right_->__color_ == kBlack && __replace_sib->__left_->__color_ == kBlack) {
-      __replace_sib->__color_ = kRed;
+    } else if (__right(__replace_sib)->__color() == kBlack && __left(__replace_sib)->__color() == kBlack) {
+      __replace_sib->__set_color(kRed);
       __replace = __target_parent;
     } else {
-      if (__replace_sib->__left_->__color_ == kBlack) {
-        __replace_sib->__right_->__color_ = kBlack;
-        __replace_sib->__color_ = kRed;
+      if (__left(__replace_sib)->__color() == kBlack) {
+        __right(__replace_sib)->__set_color(kBlack);
+        __replace_sib->__set_color(kRed);
         __lrotate(__replace_sib);
-        __replace_sib = __target_parent->__left_;
+        __replace_sib = __left(__target_parent);
       }
-      __replace_sib->__color_ = __target_parent->__color_;
-      __target_parent->__color_ = kBlack;
-      __replace_sib->__left_->__color_ = kBlack;
+      __replace_sib->__set_color(__target_parent->__color());
+      __target_parent->__set_color(kBlack);
+      __left(__replace_sib)->__set_color(kBlack);
       __rrotate(__target_parent);
       return true;
     }
@@ -1012,14 +2175,17 @@ class __tree {
   void __update_color(node_pointer_reference __replace,
                       node_pointer_reference __target_parent) {
     bool is_loop_end = false;
-    for (; !is_loop_end && __replace != __root() && __replace->__color_ == kBlack; __target_parent = __replace->__parent_) {
-      if (__replace == __target_parent->__left_) {
+    for (; !is_loop_end && __replace != __root() && __replace->__color() == kBlack; __target_parent = __replace->__parent()) {
+      if (!__replace->__is_nil() ? __replace == __target_parent->__left_
+                               : !__target_parent->__has_left()) {
         is_loop_end = __handle_left_case(__replace, __target_parent);
       } else {
         is_loop_end = __handle_right_case(__replace, __target_parent);
       }
     }
-    __replace->__color_ = kBlack;
+    if (!__replace->__is_nil()) {
+      __replace->__set_color(kBlack);
+    }
   }
 
   void __erase_node(node_pointer_reference __node_to_erase) {
@@ -1,16 +1,105 @@
 #ifndef ALGORITHM_HPP
 #define ALGORITHM_HPP
 
+#include <cstddef> // for size_t
+#include <cstring> // for memcmp
+#include <limits> // for numeric_limits
+
+#include "__config.hpp"
+#include "iterator_traits.hpp"
+#include "type_traits.hpp"
+#include "vector_iterator.hpp" // for __is_contiguous_iterator
+
+#if FT_CXX11
+#include <utility> // for move
+#endif
+
 namespace ft {
 
+// __memcmp_tag
+
+/*
+** equal and lexicographical_compare use memcmp when both ranges are arrays of
+** the same integral type
+**
+** Q: Why only integral types?
+** A: Their == compares every bit and they have no padding bytes. Floating
+**    point types do not qualify as NaN != NaN while 0.0 == -0.0
+**
+** Q: Why does lexicographical_compare need more than memcmp?
+** A: memcmp orders unsigned bytes, which matches operator< only for
+**    unsigned char, and for char where it is unsigned. For other types memcmp
+**    only locates the first mismatch, which is then compared as _Tp
+*/
+
+template <class _Iter1, class _Iter2,
+          class _Tp = typename ft::iterator_traits<_Iter1>::value_type>
+struct __memcmp_tag
+  : public integral_constant<bool,
+      ft::is_integral<_Tp>::value
+      && ft::is_same<_Tp, typename ft::iterator_traits<_Iter2>::value_type>::value
+      && ft::__is_contiguous_iterator<_Iter1, _Tp>::value
+      && ft::__is_contiguous_iterator<_Iter2, _Tp>::value> {};
+
+template <class _Tp> struct __is_unsigned_byte : public false_type {};
+template <>          struct __is_unsigned_byte<unsigned char> : public true_type {};
+template <>          struct __is_unsigned_byte<char>
+  : public integral_constant<bool, !std::numeric_limits<char>::is_signed> {};
+
+// Index of the first element that differs, or __n
+// memcmp skips equal blocks at the speed of the C library, which vectorizes it
+
+template <class _Tp>
+std::size_t __mismatch_index(const _Tp* __p1, const _Tp* __p2, std::size_t __n) {
+  const std::size_t __block = 256 / sizeof(_Tp);
+  std::size_t __i = 0;
+  while (__block <= __n - __i && std::memcmp(__p1 + __i, __p2 + __i, __block * sizeof(_Tp)) == 0) {
+    __i += __block;
+  }
+  for (; __i < __n && __p1[__i] == __p2[__i]; ++__i) {
+    ;
+  }
+  return __i;
+}
+
+template <class _Tp>
+bool __lexicographical_compare_array(const _Tp* __p1, std::size_t __n1,
+                                     const _Tp* __p2, std::size_t __n2, ft::true_type) {
+  int __r = std::memcmp(__p1, __p2, (__n1 < __n2 ? __n1 : __n2) * sizeof(_Tp));
+  return __r != 0 ? __r < 0 : __n1 < __n2;
+}
+
+template <class _Tp>
+bool __lexicographical_compare_array(const _Tp* __p1, std::size_t __n1,
+                                     const _Tp* __p2, std::size_t __n2, ft::false_type) {
+  std::size_t __n = __n1 < __n2 ? __n1 : __n2;
+  std::size_t __i = __mismatch_index(__p1, __p2, __n);
+  return __i != __n ? __p1[__i] < __p2[__i] : __n1 < __n2;
+}
+
 template <class _InputIterator1, class _InputIterator2>
-bool equal(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2) {
+bool __equal(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2,
+             ft::true_type) {
+  typedef typename ft::iterator_traits<_InputIterator1>::value_type value_type;
+  std::size_t __n = static_cast<std::size_t>(__last1 - __first1);
+  return __n == 0 || std::memcmp(&*__first1, &*__first2, __n * sizeof(value_type)) == 0;
+}
+
+template <class _InputIterator1, class _InputIterator2>
+bool __equal(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2,
+             ft::false_type) {
   for (; __first1 != __last1 && *__first1 == *__first2; ++__first1, ++__first2) {
     ;
   }
   return __first1 == __last1;
 }
 
+template <class _InputIterator1, class _InputIterator2>
+bool equal(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2) {
+  return ft::__equal(__first1, __last1, __first2,
+                     __memcmp_tag<_InputIterator1, _InputIterator2>());
+}
+
 template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
 bool equal(_InputIterator1 __first1, _InputIterator1 __last1,
            _InputIterator2 __first2, _BinaryPredicate __pred) {
@@ -21,8 +110,23 @@ bool equal(_InputIterator1 __first1, _InputIterator1 __last1,
 }
 
 template <class _InputIterator1, class _InputIterator2>
-bool lexicographical_compare(_InputIterator1 __first1, _InputIterator1 __last1,
-                             _InputIterator2 __first2, _InputIterator2 __last2) {
+bool __lexicographical_compare(_InputIterator1 __first1, _InputIterator1 __last1,
+                               _InputIterator2 __first2, _InputIterator2 __last2,
+                               ft::true_type) {
+  typedef typename ft::iterator_traits<_InputIterator1>::value_type value_type;
+  std::size_t __n1 = static_cast<std::size_t>(__last1 - __first1);
+  std::size_t __n2 = static_cast<std::size_t>(__last2 - __first2);
+  if (__n1 == 0 || __n2 == 0) {
+    return __n1 < __n2;
+  }
+  return ft::__lexicographical_compare_array<value_type>(
+      &*__first1, __n1, &*__first2, __n2, __is_unsigned_byte<value_type>());
+}
+
+template <class _InputIterator1, class _InputIterator2>
+bool __lexicographical_compare(_InputIterator1 __first1, _InputIterator1 __last1,
+                               _InputIterator2 __first2, _InputIterator2 __last2,
+                               ft::false_type) {
   for (; __first2 != __last2; ++__first1, ++__first2) {
     if (__first1 == __last1 || *__first1 < *__first2) {
       return true;
@@ -34,6 +138,13 @@ bool lexicographical_compare(_InputIterator1 __first1, _InputIterator1 __last1,
   return false;
 }
 
+template <class _InputIterator1, class _InputIterator2>
+bool lexicographical_compare(_InputIterator1 __first1, _InputIterator1 __last1,
+                             _InputIterator2 __first2, _InputIterator2 __last2) {
+  return ft::__lexicographical_compare(__first1, __last1, __first2, __last2,
+                                       __memcmp_tag<_InputIterator1, _InputIterator2>());
+}
+
 template <class _InputIterator1, class _InputIterator2, class _Compare>
 bool lexicographical_compare(_InputIterator1 __first1, _InputIterator1 __last1,
                              _InputIterator2 __first2, _InputIterator2 __last2, _Compare __comp) {
@@ -50,9 +161,15 @@ bool lexicographical_compare(_InputIterator1 __first1, _InputIterator1 __last1,
 
 template <class T>
 void swap(T& __a, T& __b) {
+#if FT_CXX11
+  T __c(std::move(__a));
+  __a = std::move(__b);
+  __b = std::move(__c);
+#else
   T __c = __a;
   __a = __b;
   __b = __c;
+#endif
 }
 
 }
@@ -0,0 +1,447 @@
+#ifndef BTREE_MAP_HPP
+#define BTREE_MAP_HPP
+
+#include <functional> // for less
+#include <memory> // for allocator
+
+#include "utility.hpp" // for ft::pair
+#include "type_traits.hpp" // for __select_first
+#include "__btree.hpp"
+
+namespace ft {
+
+/*
+** Drop-in for map over a B-tree (see __btree), for large maps of small values
+** that are mostly looked up. Unlike with map, insertions and erasures
+** invalidate all iterators and references to elements, and there are no tree
+** policies.
+**
+** Q: Why std::allocator by default?
+** A: pool_allocator serves a single object size, while leaves and internal
+**    nodes differ in size, and nodes of a few hundred bytes gain little from
+**    a pool.
+*/
+
+template <class _Key, class _Tp, class _Compare = std::less<_Key>,
+          class _Allocator = std::allocator<ft::pair<const _Key, _Tp> > >
+class btree_map {
+ public:
+
+  typedef _Key                                               key_type;
+  typedef _Tp                                                mapped_type;
+  typedef ft::pair<const key_type, mapped_type>              value_type;
+  typedef _Compare                                           key_compare;
+  typedef _Allocator                                         allocator_type;
+  typedef typename allocator_type::reference                 reference;
+  typedef typename allocator_type::const_reference           const_reference;
+  typedef typename allocator_type::pointer                   pointer;
+  typedef typename allocator_type::const_pointer             const_pointer;
+  typedef typename allocator_type::difference_type           difference_type;
+  typedef typename allocator_type::size_type                 size_type;
+
+#if FT_CXX11
+  class value_compare {
+    friend class btree_map;
+   public:
+    typedef bool       result_type;
+    typedef value_type first_argument_type;
+    typedef value_type second_argument_type;
+#else
+  class value_compare
+    : public std::binary_function<value_type, value_type, bool> {
+    friend class btree_map;
+#endif
+   protected:
+    key_compare comp;
+    value_compare(key_compare c) : comp(c) {}
+   public:
+    bool operator()(const value_type& __x, const value_type& __y) const {
+      return comp(__x.first, __y.first);
+    }
+  };
+
+ private:
+
+  typedef ft::__btree<ft::__btree_traits<key_type, value_type,
+                                         ft::__select_first<value_type>,
+                                         key_compare, allocator_type> > __base;
+
+  __base __tree_;
+
+  // Values made by __tree_.__emplace_unique_key only for a missing key
+
+  struct __make_default {
+    const key_type& __k_;
+
+    void operator()(allocator_type& __a, pointer __p) const {
+      __a.construct(__p, value_type(__k_, mapped_type()));
+    }
+  };
+
+  template <class _Arg>
+  struct __make_from {
+    const key_type& __k_;
+    const _Arg& __arg_;
+
+    void operator()(allocator_type& __a, pointer __p) const {
+      __a.construct(__p, value_type(__k_, mapped_type(__arg_)));
+    }
+  };
+
+ public:
+  typedef typename __base::iterator                          iterator;
+  typedef typename __base::const_iterator                    const_iterator;
+  typedef typename __base::reverse_iterator                  reverse_iterator;
+  typedef typename __base::const_reverse_iterator            const_reverse_iterator;
+
+  btree_map() : __tree_(key_compare(), allocator_type()) {}
+
+  explicit btree_map(const key_compare& __comp)
+    : __tree_(__comp, allocator_type()) {}
+
+  btree_map(const key_compare& __comp, const allocator_type& __a)
+    : __tree_(__comp, __a) {}
+
+  template <class _InputIterator>
+  btree_map(_InputIterator __f, _InputIterator __l,
+            const key_compare& __comp = key_compare(),
+            const allocator_type& __a = allocator_type())
+    : __tree_(__comp, __a) {
+    insert(__f, __l);
+  }
+
+  template <class _InputIterator>
+  btree_map(ft::sorted_unique_t, _InputIterator __f, _InputIterator __l,
+            const key_compare& __comp = key_compare(),
+            const allocator_type& __a = allocator_type())
+    : __tree_(__comp, __a) {
+    __tree_.insert_sorted_unique(__f, __l);
+  }
+
+  btree_map(const btree_map& __m) : __tree_(__m.__tree_) {}
+
+  ~btree_map() {}
+
+  btree_map& operator=(const btree_map& __m) {
+    if (this != &__m) {
+      __tree_ = __m.__tree_;
+    }
+    return *this;
+  }
+
+#if FT_CXX11
+  btree_map(btree_map&& __m) : __tree_(std::move(__m.__tree_)) {}
+
+  btree_map& operator=(btree_map&& __m) {
+    __tree_ = std::move(__m.__tree_);
+    return *this;
+  }
+#endif
+
+  // Iterators
+
+  iterator begin() { return __tree_.begin(); }
+
+  const_iterator begin() const { return __tree_.begin(); }
+
+  iterator end() { return __tree_.end(); }
+
+  const_iterator end() const { return __tree_.end(); }
+
+  reverse_iterator rbegin() { return __tree_.rbegin(); }
+
+  const_reverse_iterator rbegin() const { return __tree_.rbegin(); }
+
+  reverse_iterator rend() {return __tree_.rend(); }
+
+  const_reverse_iterator rend() const { return __tree_.rend(); }
+
+  // Capacity
+
+  bool empty() const { return __tree_.size() == 0; }
+
+  size_type size() const { return __tree_.size(); }
+
+  size_type max_size() const { return __tree_.max_size(); }
+
+  // Element access
+
+  mapped_type& operator[](const key_type& __k) {
+    __make_default __make = {__k};
+    return (*__tree_.__emplace_unique_key(__k, __make).first).second;
+  }
+
+#if FT_CXX11
+  mapped_type& operator[](key_type&& __k) {
+    return (*try_emplace(std::move(__k)).first).second;
+  }
+#endif
+
+  // Modifiers
+
+  ft::pair<iterator, bool> insert(const value_type& __v) {
+    return __tree_.insert(__v);
+  }
+
+  iterator insert(iterator __it, const value_type& __v) {
+    return __tree_.insert(__it, __v);
+  }
+
+#if FT_CXX11
+  ft::pair<iterator, bool> insert(value_type&& __v) {
+    return __tree_.emplace(std::move(__v));
+  }
+
+  iterator insert(iterator __it, value_type&& __v) {
+    return __tree_.emplace_hint(__it, std::move(__v));
+  }
+
+  template <class... _Args>
+  ft::pair<iterator, bool> emplace(_Args&&... __args) {
+    return __tree_.emplace(std::forward<_Args>(__args)...);
+  }
+
+  template <class... _Args>
+  iterator emplace_hint(iterator __it, _Args&&... __args) {
+    return __tree_.emplace_hint(__it, std::forward<_Args>(__args)...);
+  }
+#endif
+
+  template <class _InputIterator>
+  typename ft::enable_if<!ft::is_integral<_InputIterator>::value, void>::type
+  insert(_InputIterator __first, _InputIterator __last) {
+    __tree_.insert(__first, __last);
+  }
+
+  template <class _InputIterator>
+  void insert(ft::sorted_unique_t, _InputIterator __first, _InputIterator __last) {
+    __tree_.insert_sorted_unique(__first, __last);
+  }
+
+  // try_emplace, insert_or_assign and upsert as in map
+
+#if FT_CXX11
+  template <class... _Args>
+  ft::pair<iterator, bool> try_emplace(const key_type& __k, _Args&&... __args) {
+    return __tree_.__emplace_unique_key(__k, [&](allocator_type& __a, pointer __p) {
+      std::allocator_traits<allocator_type>::construct(
+          __a, __p, __k, mapped_type(std::forward<_Args>(__args)...));
+    });
+  }
+
+  template <class... _Args>
+  ft::pair<iterator, bool> try_emplace(key_type&& __k, _Args&&... __args) {
+    return __tree_.__emplace_unique_key(__k, [&](allocator_type& __a, pointer __p) {
+      std::allocator_traits<allocator_type>::construct(
+          __a, __p, std::move(__k), mapped_type(std::forward<_Args>(__args)...));
+    });
+  }
+
+  template <class _Mp>
+  ft::pair<iterator, bool> insert_or_assign(const key_type& __k, _Mp&& __m) {
+    ft::pair<iterator, bool> __r = try_emplace(__k, std::forward<_Mp>(__m));
+    if (!__r.second) {
+      (*__r.first).second = std::forward<_Mp>(__m);
+    }
+    return __r;
+  }
+
+  template <class _Mp>
+  ft::pair<iterator, bool> insert_or_assign(key_type&& __k, _Mp&& __m) {
+    ft::pair<iterator, bool> __r = try_emplace(std::move(__k), std::forward<_Mp>(__m));
+    if (!__r.second) {
+      (*__r.first).second = std::forward<_Mp>(__m);
+    }
+    return __r;
+  }
+#else
+  ft::pair<iterator, bool> try_emplace(const key_type& __k) {
+    __make_default __make = {__k};
+    return __tree_.__emplace_unique_key(__k, __make);
+  }
+
+  template <class _Arg>
+  ft::pair<iterator, bool> try_emplace(const key_type& __k, const _Arg& __arg) {
+    __make_from<_Arg> __make = {__k, __arg};
+    return __tree_.__emplace_unique_key(__k, __make);
+  }
+
+  template <class _Mp>
+  ft::pair<iterator, bool> insert_or_assign(const key_type& __k, const _Mp& __m) {
+    ft::pair<iterator, bool> __r = try_emplace(__k, __m);
+    if (!__r.second) {
+      (*__r.first).second = __m;
+    }
+    return __r;
+  }
+#endif
+
+  template <class _Fn>
+  ft::pair<iterator, bool> upsert(const key_type& __k, _Fn __f) {
+    __make_default __make = {__k};
+    ft::pair<iterator, bool> __r = __tree_.__emplace_unique_key(__k, __make);
+    __f((*__r.first).second);
+    return __r;
+  }
+
+  void erase(iterator __p) {
+    __tree_.erase(__p);
+  }
+
+  size_type erase(const key_type& __k) {
+    return __tree_.erase(__k);
+  }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, size_type>::type
+  erase(const _K2& __k) {
+    return __tree_.erase(__k);
+  }
+
+  void erase(iterator __first, iterator __last) {
+    __tree_.erase(__first, __last);
+  }
+
+  void swap(btree_map& __m) { __tree_.swap(__m.__tree_); }
+
+  void clear() { __tree_.clear(); }
+
+  // Observers
+
+  key_compare key_comp() const { return __tree_.key_comp(); }
+
+  value_compare value_comp() const { return value_compare(__tree_.key_comp()); }
+
+  // Operations
+
+  iterator find(const key_type& __k) { return __tree_.find(__k); }
+
+  const_iterator find(const key_type& __k) const { return __tree_.find(__k); }
+
+  size_type count(const key_type& __k) const { return __tree_.count(__k); }
+
+  iterator lower_bound(const key_type& __k) { return __tree_.lower_bound(__k); }
+
+  const_iterator lower_bound(const key_type& __k) const { return __tree_.lower_bound(__k); }
+
+  iterator upper_bound(const key_type& __k) { return __tree_.upper_bound(__k); }
+
+  const_iterator upper_bound(const key_type& __k) const { return __tree_.upper_bound(__k); }
+
+  ft::pair<iterator, iterator> equal_range(const key_type& __k) {
+    return __tree_.equal_range(__k);
+  }
+
+  ft::pair<const_iterator, const_iterator> equal_range(const key_type& __k) const {
+    return __tree_.equal_range(__k);
+  }
+
+  // Lookups by keys of another type, when key_compare is transparent
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  find(const _K2& __k) { return __tree_.find(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  find(const _K2& __k) const { return __tree_.find(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, size_type>::type
+  count(const _K2& __k) const { return __tree_.count(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  lower_bound(const _K2& __k) { return __tree_.lower_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  lower_bound(const _K2& __k) const { return __tree_.lower_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  upper_bound(const _K2& __k) { return __tree_.upper_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  upper_bound(const _K2& __k) const { return __tree_.upper_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value,
+                         ft::pair<iterator, iterator> >::type
+  equal_range(const _K2& __k) {
+    return __tree_.equal_range(__k);
+  }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value,
+                         ft::pair<const_iterator, const_iterator> >::type
+  equal_range(const _K2& __k) const {
+    return __tree_.equal_range(__k);
+  }
+
+  // Allocator
+
+  allocator_type get_allocator() const { return __tree_.get_allocator(); }
+
+  // Non-member functions
+  template <class _K1, class _T1, class _C1, class _A1>
+  friend bool operator==(const btree_map<_K1, _T1, _C1, _A1>& __x,
+                         const btree_map<_K1, _T1, _C1, _A1>& __y);
+
+  template <class _K1, class _T1, class _C1, class _A1>
+  friend bool operator< (const btree_map<_K1, _T1, _C1, _A1>& __x,
+                         const btree_map<_K1, _T1, _C1, _A1>& __y);
+
+};
+
+// Non-member functions
+
+template <class _Key, class _Tp, class _Compare, class _Allocator>
+bool operator==(const btree_map<_Key, _Tp, _Compare, _Allocator>& __x,
+                const btree_map<_Key, _Tp, _Compare, _Allocator>& __y) {
+  return __x.__tree_ == __y.__tree_;
+}
+
+template <class _Key, class _Tp, class _Compare, class _Allocator>
+inline bool operator!=(const btree_map<_Key, _Tp, _Compare, _Allocator>& __x,
+                       const btree_map<_Key, _Tp, _Compare, _Allocator>& __y) {
+  return !(__x == __y);
+}
+
+template <class _Key, class _Tp, class _Compare, class _Allocator>
+bool operator<(const btree_map<_Key, _Tp, _Compare, _Allocator>& __x,
+               const btree_map<_Key, _Tp, _Compare, _Allocator>& __y) {
+  return __x.__tree_ < __y.__tree_;
+}
+
+template <class _Key, class _Tp, class _Compare, class _Allocator>
+inline bool operator>(const btree_map<_Key, _Tp, _Compare, _Allocator>& __x,
+                      const btree_map<_Key, _Tp, _Compare, _Allocator>& __y) {
+  return __y < __x;
+}
+
+template <class _Key, class _Tp, class _Compare, class _Allocator>
+inline bool operator<=(const btree_map<_Key, _Tp, _Compare, _Allocator>& __x,
+                       const btree_map<_Key, _Tp, _Compare, _Allocator>& __y) {
+  return !(__y < __x);
+}
+
+template <class _Key, class _Tp, class _Compare, class _Allocator>
+inline bool operator>=(const btree_map<_Key, _Tp, _Compare, _Allocator>& __x,
+                       const btree_map<_Key, _Tp, _Compare, _Allocator>& __y) {
+  return !(__x < __y);
+}
+
+template <class _Key, class _Tp, class _Compare, class _Allocator>
+inline void swap(btree_map<_Key, _Tp, _Compare, _Allocator>& __x,
+                 btree_map<_Key, _Tp, _Compare, _Allocator>& __y) {
+  __x.swap(__y);
+}
+
+template <class _Key, class _Tp, class _Compare, class _Allocator>
+struct is_swap_relocatable<btree_map<_Key, _Tp, _Compare, _Allocator> > : public true_type {};
+
+}
+
+#endif // BTREE_MAP_HPP
@@ -0,0 +1,87 @@
+#ifndef GROWTH_POLICY_HPP
+#define GROWTH_POLICY_HPP
+
+#include <cstddef> // for size_t
+
+namespace ft {
+
+/*
+** Growth policies decide the new capacity of a vector when an insertion does
+** not fit in the current one. Each policy provides
+**
+**   static std::size_t recommend(std::size_t __cap, std::size_t __required,
+**                                std::size_t __max_size, std::size_t __elem_size);
+**
+** which returns a capacity in [__required, __max_size] given the current
+** capacity and the size the vector needs to hold after the insertion.
+** __elem_size is sizeof(value_type) so policies can reason in bytes.
+*/
+
+// Doubles the capacity (default, same as libc++)
+
+struct growth_doubling {
+  static std::size_t recommend(std::size_t __cap, std::size_t __required,
+                               std::size_t __max_size, std::size_t) {
+    __cap = __max_size - __cap < __cap ? 0 : __cap + __cap;
+    return __cap < __required ? __required : __cap;
+  }
+};
+
+/*
+** Grows by half of the current capacity
+**
+** Q: Why 1.5x?
+** A: With a factor below the golden ratio, the sum of previously freed blocks
+**    eventually becomes large enough for the allocator to reuse them, and the
+**    peak memory during a reallocation is 2.5x the old block instead of 3x
+*/
+
+struct growth_factor_1_5 {
+  static std::size_t recommend(std::size_t __cap, std::size_t __required,
+                               std::size_t __max_size, std::size_t) {
+    __cap = __max_size - __cap < __cap / 2 ? 0 : __cap + __cap / 2;
+    return __cap < __required ? __required : __cap;
+  }
+};
+
+// Grows by a fixed number of elements
+
+template <std::size_t _Increment>
+struct growth_fixed {
+  static std::size_t recommend(std::size_t __cap, std::size_t __required,
+                               std::size_t __max_size, std::size_t) {
+    __cap = __max_size - __cap < _Increment ? 0 : __cap + _Increment;
+    return __cap < __required ? __required : __cap;
+  }
+};
+
+/*
+** Rounds the capacity chosen by _Base up so the allocation fills whole pages
+** once it is at least a page large, and whole malloc size classes (multiples
+** of _Granularity bytes) below that. The tail the allocator would hand out
+** anyway becomes usable capacity instead of being wasted.
+*/
+
+template <class _Base = growth_doubling, std::size_t _PageSize = 4096,
+          std::size_t _Granularity = 16>
+struct growth_page_aligned {
+  static std::size_t recommend(std::size_t __cap, std::size_t __required,
+                               std::size_t __max_size, std::size_t __elem_size) {
+    __cap = _Base::recommend(__cap, __required, __max_size, __elem_size);
+    if (static_cast<std::size_t>(-1) / __elem_size < __cap) {
+      return __cap;
+    }
+    std::size_t __bytes = __cap * __elem_size;
+    std::size_t __unit = __bytes < _PageSize ? _Granularity : _PageSize;
+    std::size_t __rounded = (__bytes + __unit - 1) / __unit * __unit;
+    if (__rounded < __bytes) {
+      return __cap;
+    }
+    __rounded /= __elem_size;
+    return __max_size < __rounded ? __max_size : __rounded;
+  }
+};
+
+} // namespace ft
+
+#endif // GROWTH_POLICY_HPP
@@ -71,18 +71,19 @@ distance(_InputIter __first, _InputIter __last) {
 
 // ft::reverse_iterator
 
+// Q: Why not derive from std::iterator?
+// A: std::iterator is deprecated since C++17, so the member types are declared
+// directly to keep the C++17 build free of warnings
+
 template <class _Iter>
-class reverse_iterator : public std::iterator<
-    typename ft::iterator_traits<_Iter>::iterator_category,
-    typename ft::iterator_traits<_Iter>::value_type,
-    typename ft::iterator_traits<_Iter>::difference_type,
-    typename ft::iterator_traits<_Iter>::pointer,
-    typename ft::iterator_traits<_Iter>::reference> {
+class reverse_iterator {
 
  protected:
   _Iter current;
  public:
   typedef _Iter                                                iterator_type;
+  typedef typename ft::iterator_traits<_Iter>::iterator_category iterator_category;
+  typedef typename ft::iterator_traits<_Iter>::value_type      value_type;
   typedef typename ft::iterator_traits<_Iter>::difference_type difference_type;
   typedef typename ft::iterator_traits<_Iter>::reference       reference;
   typedef typename ft::iterator_traits<_Iter>::pointer         pointer;
@@ -2,16 +2,18 @@
 #define MAP_HPP
 
 #include <functional> // for less
-#include <memory> // for allocator
 
 #include "utility.hpp" // for ft::pair
 #include "type_traits.hpp" // for __select_first
+#include "pool_allocator.hpp"
+#include "tree_policy.hpp"
 #include "__tree.hpp"
 
 namespace ft {
 
 template <class _Key, class _Tp, class _Compare = std::less<_Key>,
-          class _Allocator = std::allocator<ft::pair<const _Key, _Tp> > >
+          class _Allocator = ft::pool_allocator<ft::pair<const _Key, _Tp> >,
+          class _TreePolicy = ft::tree_plain>
 class map {
  public:
 
@@ -20,6 +22,7 @@ class map {
   typedef ft::pair<const key_type, mapped_type>              value_type;
   typedef _Compare                                           key_compare;
   typedef _Allocator                                         allocator_type;
+  typedef _TreePolicy                                        tree_policy;
   typedef typename allocator_type::reference                 reference;
   typedef typename allocator_type::const_reference           const_reference;
   typedef typename allocator_type::pointer                   pointer;
@@ -30,9 +33,21 @@ class map {
   // Q: Understand why "friend class map" is needed here
   // A: Because map class needs to have access to a protected constructor of value_compare
 
+  // std::binary_function is deprecated since C++17, so the C++11 build
+  // declares its member types directly
+
+#if FT_CXX11
+  class value_compare {
+    friend class map;
+   public:
+    typedef bool       result_type;
+    typedef value_type first_argument_type;
+    typedef value_type second_argument_type;
+#else
   class value_compare
     : public std::binary_function<value_type, value_type, bool> {
     friend class map;
+#endif
    protected:
     key_compare comp;
     value_compare(key_compare c) : comp(c) {}
@@ -46,15 +61,37 @@ class map {
 
   typedef ft::__tree<ft::__tree_traits<key_type, value_type,
                                        ft::__select_first<value_type>,
-                                       key_compare, allocator_type> > __base;
+                                       key_compare, allocator_type,
+                                       tree_policy> > __base;
 
   __base __tree_;
 
+  // Values made by __tree_.__emplace_unique_key only for a missing key
+
+  struct __make_default {
+    const key_type& __k_;
+
+    void operator()(allocator_type& __a, pointer __p) const {
+      __a.construct(__p, value_type(__k_, mapped_type()));
+    }
+  };
+
+  template <class _Arg>
+  struct __make_from {
+    const key_type& __k_;
+    const _Arg& __arg_;
+
+    void operator()(allocator_type& __a, pointer __p) const {
+      __a.construct(__p, value_type(__k_, mapped_type(__arg_)));
+    }
+  };
+
  public:
   typedef typename __base::iterator                          iterator;
   typedef typename __base::const_iterator                    const_iterator;
   typedef typename __base::reverse_iterator                  reverse_iterator;
   typedef typename __base::const_reverse_iterator            const_reverse_iterator;
+  typedef typename __base::aggregate_type                    aggregate_type;
 
   map() : __tree_(key_compare(), allocator_type()) {}
 
@@ -72,6 +109,14 @@ class map {
     insert(__f, __l);
   }
 
+  template <class _InputIterator>
+  map(ft::sorted_unique_t, _InputIterator __f, _InputIterator __l,
+      const key_compare& __comp = key_compare(),
+      const allocator_type& __a = allocator_type())
+    : __tree_(__comp, __a) {
+    __tree_.insert_sorted_unique(__f, __l);
+  }
+
   map(const map& __m) : __tree_(__m.__tree_) {}
 
   ~map() {}
@@ -83,6 +128,15 @@ class map {
     return *this;
   }
 
+#if FT_CXX11
+  map(map&& __m) : __tree_(std::move(__m.__tree_)) {}
+
+  map& operator=(map&& __m) {
+    __tree_ = std::move(__m.__tree_);
+    return *this;
+  }
+#endif
+
   // Iterators
 
   iterator begin() { return __tree_.begin(); }
@@ -109,14 +163,26 @@ class map {
 
   size_type max_size() const { return __tree_.max_size(); }
 
+  size_type capacity() const { return __tree_.capacity(); }
+
+  void reserve(size_type __n) { __tree_.reserve(__n); }
+
 
   // Element access
 
+  // The key is looked up first, and a mapped_type is only made if it is missing
+
   mapped_type& operator[](const key_type& __k) {
-    iterator __it = insert(value_type(__k, mapped_type())).first;
-    return (*__it).second;
+    __make_default __make = {__k};
+    return (*__tree_.__emplace_unique_key(__k, __make).first).second;
   }
 
+#if FT_CXX11
+  mapped_type& operator[](key_type&& __k) {
+    return (*try_emplace(std::move(__k)).first).second;
+  }
+#endif
+
   // Modifiers
 
   ft::pair<iterator, bool> insert(const value_type& __v) {
@@ -127,12 +193,115 @@ class map {
     return __tree_.insert(__it, __v);
   }
 
+#if FT_CXX11
+  ft::pair<iterator, bool> insert(value_type&& __v) {
+    return __tree_.emplace(std::move(__v));
+  }
+
+  iterator insert(iterator __it, value_type&& __v) {
+    return __tree_.emplace_hint(__it, std::move(__v));
+  }
+
+  template <class... _Args>
+  ft::pair<iterator, bool> emplace(_Args&&... __args) {
+    return __tree_.emplace(std::forward<_Args>(__args)...);
+  }
+
+  template <class... _Args>
+  iterator emplace_hint(iterator __it, _Args&&... __args) {
+    return __tree_.emplace_hint(__it, std::forward<_Args>(__args)...);
+  }
+#endif
+
   template <class _InputIterator>
   typename ft::enable_if<!ft::is_integral<_InputIterator>::value, void>::type
   insert(_InputIterator __first, _InputIterator __last) {
     __tree_.insert(__first, __last);
   }
 
+  template <class _InputIterator>
+  void insert(ft::sorted_unique_t, _InputIterator __first, _InputIterator __last) {
+    __tree_.insert_sorted_unique(__first, __last);
+  }
+
+  /*
+  ** try_emplace and insert_or_assign, as in C++17, and upsert find the key
+  ** and the place to insert it with a single descent. Nothing is built when
+  ** the key is already there. Without variadic templates, try_emplace takes
+  ** at most one argument for the mapped_type.
+  */
+
+#if FT_CXX11
+  template <class... _Args>
+  ft::pair<iterator, bool> try_emplace(const key_type& __k, _Args&&... __args) {
+    return __tree_.__emplace_unique_key(__k, [&](allocator_type& __a, pointer __p) {
+      std::allocator_traits<allocator_type>::construct(
+          __a, __p, __k, mapped_type(std::forward<_Args>(__args)...));
+    });
+  }
+
+  template <class... _Args>
+  ft::pair<iterator, bool> try_emplace(key_type&& __k, _Args&&... __args) {
+    return __tree_.__emplace_unique_key(__k, [&](allocator_type& __a, pointer __p) {
+      std::allocator_traits<allocator_type>::construct(
+          __a, __p, std::move(__k), mapped_type(std::forward<_Args>(__args)...));
+    });
+  }
+
+  template <class _Mp>
+  ft::pair<iterator, bool> insert_or_assign(const key_type& __k, _Mp&& __m) {
+    ft::pair<iterator, bool> __r = try_emplace(__k, std::forward<_Mp>(__m));
+    if (!__r.second) {
+      (*__r.first).second = std::forward<_Mp>(__m);
+      __tree_.refresh(__r.first);
+    }
+    return __r;
+  }
+
+  template <class _Mp>
+  ft::pair<iterator, bool> insert_or_assign(key_type&& __k, _Mp&& __m) {
+    ft::pair<iterator, bool> __r = try_emplace(std::move(__k), std::forward<_Mp>(__m));
+    if (!__r.second) {
+      (*__r.first).second = std::forward<_Mp>(__m);
+      __tree_.refresh(__r.first);
+    }
+    return __r;
+  }
+#else
+  ft::pair<iterator, bool> try_emplace(const key_type& __k) {
+    __make_default __make = {__k};
+    return __tree_.__emplace_unique_key(__k, __make);
+  }
+
+  template <class _Arg>
+  ft::pair<iterator, bool> try_emplace(const key_type& __k, const _Arg& __arg) {
+    __make_from<_Arg> __make = {__k, __arg};
+    return __tree_.__emplace_unique_key(__k, __make);
+  }
+
+  template <class _Mp>
+  ft::pair<iterator, bool> insert_or_assign(const key_type& __k, const _Mp& __m) {
+    ft::pair<iterator, bool> __r = try_emplace(__k, __m);
+    if (!__r.second) {
+      (*__r.first).second = __m;
+      __tree_.refresh(__r.first);
+    }
+    return __r;
+  }
+#endif
+
+  // Calls __f on the mapped value of __k, value-initialized first if the key
+  // was missing, and tells whether it was
+
+  template <class _Fn>
+  ft::pair<iterator, bool> upsert(const key_type& __k, _Fn __f) {
+    __make_default __make = {__k};
+    ft::pair<iterator, bool> __r = __tree_.__emplace_unique_key(__k, __make);
+    __f((*__r.first).second);
+    __tree_.refresh(__r.first);
+    return __r;
+  }
+
   void erase(iterator __p) {
     __tree_.erase(__p);
   }
@@ -141,6 +310,12 @@ class map {
     return __tree_.erase(__k);
   }
 
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, size_type>::type
+  erase(const _K2& __k) {
+    return __tree_.erase(__k);
+  }
+
   void erase(iterator __first, iterator __last) {
     __tree_.erase(__first, __last);
   }
@@ -149,6 +324,10 @@ class map {
 
   void clear() { __tree_.clear(); }
 
+  // Like clear(), but the nodes are kept for the next insertions
+
+  void clear_keep_capacity() { __tree_.clear_keep_capacity(); }
+
   // Observers
 
   key_compare key_comp() const { return __tree_.key_comp(); }
@@ -179,65 +358,134 @@ class map {
     return __tree_.equal_range(__k);
   }
 
+  // Lookups by keys of another type, when key_compare is transparent
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  find(const _K2& __k) { return __tree_.find(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  find(const _K2& __k) const { return __tree_.find(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, size_type>::type
+  count(const _K2& __k) const { return __tree_.count(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  lower_bound(const _K2& __k) { return __tree_.lower_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  lower_bound(const _K2& __k) const { return __tree_.lower_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  upper_bound(const _K2& __k) { return __tree_.upper_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  upper_bound(const _K2& __k) const { return __tree_.upper_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value,
+                         ft::pair<iterator, iterator> >::type
+  equal_range(const _K2& __k) {
+    return __tree_.equal_range(__k);
+  }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value,
+                         ft::pair<const_iterator, const_iterator> >::type
+  equal_range(const _K2& __k) const {
+    return __tree_.equal_range(__k);
+  }
+
+  // Order statistics, only with a tree_order_statistic policy
+
+  iterator nth(size_type __k) { return __tree_.nth(__k); }
+
+  const_iterator nth(size_type __k) const { return __tree_.nth(__k); }
+
+  size_type rank(const key_type& __k) const { return __tree_.rank(__k); }
+
+  // Range aggregates, only with a tree_aggregate policy. aggregate(__lo, __hi)
+  // combines the values of the keys from __lo to __hi, both included
+
+  aggregate_type aggregate() const { return __tree_.aggregate(); }
+
+  aggregate_type aggregate(const key_type& __lo, const key_type& __hi) const {
+    return __tree_.aggregate(__lo, __hi);
+  }
+
+  // To call after changing the mapped value of __p in place, through an
+  // iterator or operator[]
+
+  void refresh(iterator __p) { __tree_.refresh(__p); }
+
   // Allocator
 
   allocator_type get_allocator() const { return __tree_.get_allocator(); }
 
   // Non-member functions
-  template <class _K1, class _T1, class _C1, class _A1>
-  friend bool operator==(const map<_K1, _T1, _C1, _A1>& __x,
-                         const map<_K1, _T1, _C1, _A1>& __y);
+  template <class _K1, class _T1, class _C1, class _A1, class _P1>
+  friend bool operator==(const map<_K1, _T1, _C1, _A1, _P1>& __x,
+                         const map<_K1, _T1, _C1, _A1, _P1>& __y);
 
-  template <class _K1, class _T1, class _C1, class _A1>
-  friend bool operator< (const map<_K1, _T1, _C1, _A1>& __x,
-                         const map<_K1, _T1, _C1, _A1>& __y);
+  template <class _K1, class _T1, class _C1, class _A1, class _P1>
+  friend bool operator< (const map<_K1, _T1, _C1, _A1, _P1>& __x,
+                         const map<_K1, _T1, _C1, _A1, _P1>& __y);
 
 };
 
 // Non-member functions
 
-template <class _Key, class _Tp, class _Compare, class _Allocator>
-bool operator==(const map<_Key, _Tp, _Compare, _Allocator>& __x,
-                       const map<_Key, _Tp, _Compare, _Allocator>& __y) {
+template <class _Key, class _Tp, class _Compare, class _Allocator, class _TreePolicy>
+bool operator==(const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __x,
+                       const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __y) {
   return __x.__tree_ == __y.__tree_;
 }
 
-template <class _Key, class _Tp, class _Compare, class _Allocator>
-inline bool operator!=(const map<_Key, _Tp, _Compare, _Allocator>& __x,
-                       const map<_Key, _Tp, _Compare, _Allocator>& __y) {
+template <class _Key, class _Tp, class _Compare, class _Allocator, class _TreePolicy>
+inline bool operator!=(const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __x,
+                       const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __y) {
   return !(__x == __y);
 }
 
-template <class _Key, class _Tp, class _Compare, class _Allocator>
-bool operator<(const map<_Key, _Tp, _Compare, _Allocator>& __x,
-                      const map<_Key, _Tp, _Compare, _Allocator>& __y) {
+template <class _Key, class _Tp, class _Compare, class _Allocator, class _TreePolicy>
+bool operator<(const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __x,
+                      const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __y) {
   return __x.__tree_ < __y.__tree_;
 }
 
-template <class _Key, class _Tp, class _Compare, class _Allocator>
-inline bool operator>(const map<_Key, _Tp, _Compare, _Allocator>& __x,
-                      const map<_Key, _Tp, _Compare, _Allocator>& __y) {
+template <class _Key, class _Tp, class _Compare, class _Allocator, class _TreePolicy>
+inline bool operator>(const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __x,
+                      const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __y) {
   return __y < __x;
 }
 
-template <class _Key, class _Tp, class _Compare, class _Allocator>
-inline bool operator<=(const map<_Key, _Tp, _Compare, _Allocator>& __x,
-                       const map<_Key, _Tp, _Compare, _Allocator>& __y) {
+template <class _Key, class _Tp, class _Compare, class _Allocator, class _TreePolicy>
+inline bool operator<=(const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __x,
+                       const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __y) {
   return !(__y < __x);
 }
 
-template <class _Key, class _Tp, class _Compare, class _Allocator>
-inline bool operator>=(const map<_Key, _Tp, _Compare, _Allocator>& __x,
-                       const map<_Key, _Tp, _Compare, _Allocator>& __y) {
+template <class _Key, class _Tp, class _Compare, class _Allocator, class _TreePolicy>
+inline bool operator>=(const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __x,
+                       const map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __y) {
   return !(__x < __y);
 }
 
-template <class _Key, class _Tp, class _Compare, class _Allocator>
-inline void swap(map<_Key, _Tp, _Compare, _Allocator>& __x,
-                 map<_Key, _Tp, _Compare, _Allocator>& __y) {
+template <class _Key, class _Tp, class _Compare, class _Allocator, class _TreePolicy>
+inline void swap(map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __x,
+                 map<_Key, _Tp, _Compare, _Allocator, _TreePolicy>& __y) {
   __x.swap(__y);
 }
 
+template <class _Key, class _Tp, class _Compare, class _Allocator, class _TreePolicy>
+struct is_swap_relocatable<map<_Key, _Tp, _Compare, _Allocator, _TreePolicy> > : public true_type {};
+
 }
 
 #endif // MAP_HPP
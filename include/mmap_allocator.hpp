@@ -0,0 +1,207 @@
+#ifndef MMAP_ALLOCATOR_HPP
+#define MMAP_ALLOCATOR_HPP
+
+#include <cstddef> // for size_t, ptrdiff_t
+#include <cstdlib> // for malloc, calloc, realloc, free
+#include <cstring> // for memcpy
+#include <limits> // for numeric_limits
+#include <new> // for bad_alloc, placement new
+#include <sys/mman.h> // for mmap, mremap, munmap
+#include <unistd.h> // for sysconf
+
+#include "type_traits.hpp"
+
+namespace ft {
+
+// has_reallocate
+
+/*
+** True for allocators providing
+**
+**   pointer reallocate(pointer __p, size_type __old_n, size_type __new_n);
+**
+** which resizes a block returned by allocate(__old_n) to hold __new_n objects,
+** keeping its bytes and possibly its address. vector uses it for elements that
+** can be relocated bitwise. Specialize it for user allocators that support it.
+*/
+
+template <class _Allocator>
+struct has_reallocate : public false_type {};
+
+// has_allocate_zeroed
+
+/*
+** True for allocators providing
+**
+**   pointer allocate_zeroed(size_type __n);
+**
+** which behaves like allocate(__n) but returns memory whose bytes are all zero,
+** e.g. from calloc or fresh anonymous pages that the kernel zeroes on first
+** touch. vector uses it to value-initialize bitwise copyable elements without
+** writing them.
+*/
+
+template <class _Allocator>
+struct has_allocate_zeroed : public false_type {};
+
+/*
+** Allocator backed by malloc for small blocks and by anonymous mappings for
+** blocks of at least _Threshold bytes
+**
+** Q: What does it buy over std::allocator?
+** A: reallocate() can grow a block without copying it. realloc extends small
+**    blocks in place when the heap allows, and on Linux mremap moves large
+**    blocks by remapping their pages, so growing a 2 GB buffer to 4 GB only
+**    touches page tables. Elsewhere, large blocks fall back to map, copy and
+**    unmap.
+*/
+
+template <class _Tp, std::size_t _Threshold = 1024 * 1024>
+class mmap_allocator {
+ public:
+  typedef _Tp              value_type;
+  typedef _Tp*             pointer;
+  typedef const _Tp*       const_pointer;
+  typedef _Tp&             reference;
+  typedef const _Tp&       const_reference;
+  typedef std::size_t      size_type;
+  typedef std::ptrdiff_t   difference_type;
+
+  template <class _Up>
+  struct rebind { typedef mmap_allocator<_Up, _Threshold> other; };
+
+  mmap_allocator() {}
+
+  mmap_allocator(const mmap_allocator&) {}
+
+  template <class _Up>
+  mmap_allocator(const mmap_allocator<_Up, _Threshold>&) {}
+
+  ~mmap_allocator() {}
+
+  pointer address(reference __x) const { return &__x; }
+
+  const_pointer address(const_reference __x) const { return &__x; }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(value_type);
+  }
+
+  pointer allocate(size_type __n, const void* = 0) {
+    if (max_size() < __n) {
+      throw std::bad_alloc();
+    }
+    void* __p = __is_mapped(__n) ? __map(__map_length(__n)) : std::malloc(__bytes(__n));
+    if (__p == NULL && __n != 0) {
+      throw std::bad_alloc();
+    }
+    return static_cast<pointer>(__p);
+  }
+
+  // Anonymous mappings are already zero filled, lazily, by the kernel
+
+  pointer allocate_zeroed(size_type __n) {
+    if (max_size() < __n) {
+      throw std::bad_alloc();
+    }
+    void* __p = __is_mapped(__n) ? __map(__map_length(__n))
+                                 : std::calloc(__n, sizeof(value_type));
+    if (__p == NULL && __n != 0) {
+      throw std::bad_alloc();
+    }
+    return static_cast<pointer>(__p);
+  }
+
+  void deallocate(pointer __p, size_type __n) {
+    if (__p == NULL) {
+      ;
+    } else if (__is_mapped(__n)) {
+      ::munmap(static_cast<void*>(__p), __map_length(__n));
+    } else {
+      std::free(static_cast<void*>(__p));
+    }
+  }
+
+  // On failure, throws bad_alloc and leaves the block of __old_n untouched
+
+  pointer reallocate(pointer __p, size_type __old_n, size_type __new_n) {
+    if (__p == NULL) {
+      return allocate(__new_n);
+    } else if (max_size() < __new_n) {
+      throw std::bad_alloc();
+    } else if (!__is_mapped(__old_n) && !__is_mapped(__new_n)) {
+      void* __r = std::realloc(static_cast<void*>(__p), __bytes(__new_n));
+      if (__r == NULL) {
+        throw std::bad_alloc();
+      }
+      return static_cast<pointer>(__r);
+    }
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+    if (__is_mapped(__old_n) && __is_mapped(__new_n)) {
+      void* __r = ::mremap(static_cast<void*>(__p), __map_length(__old_n),
+                           __map_length(__new_n), MREMAP_MAYMOVE);
+      if (__r == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      return static_cast<pointer>(__r);
+    }
+#endif
+    pointer __r = allocate(__new_n);
+    std::memcpy(static_cast<void*>(__r), static_cast<const void*>(__p),
+                __bytes(__old_n < __new_n ? __old_n : __new_n));
+    deallocate(__p, __old_n);
+    return __r;
+  }
+
+  void construct(pointer __p, const_reference __v) {
+    ::new(static_cast<void*>(__p)) value_type(__v);
+  }
+
+  void destroy(pointer __p) { __p->~value_type(); }
+
+ private:
+
+  static size_type __bytes(size_type __n) { return __n * sizeof(value_type); }
+
+  static bool __is_mapped(size_type __n) { return _Threshold <= __bytes(__n); }
+
+  static size_type __map_length(size_type __n) {
+    size_type __page = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+    return (__bytes(__n) + __page - 1) / __page * __page;
+  }
+
+  static void* __map(size_type __len) {
+#if defined(MAP_ANONYMOUS)
+    void* __p = ::mmap(NULL, __len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#else
+    void* __p = ::mmap(NULL, __len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+#endif
+    return __p == MAP_FAILED ? NULL : __p;
+  }
+
+}; // class mmap_allocator
+
+template <class _T1, class _T2, std::size_t _Threshold>
+bool operator==(const mmap_allocator<_T1, _Threshold>&,
+                const mmap_allocator<_T2, _Threshold>&) {
+  return true;
+}
+
+template <class _T1, class _T2, std::size_t _Threshold>
+bool operator!=(const mmap_allocator<_T1, _Threshold>&,
+                const mmap_allocator<_T2, _Threshold>&) {
+  return false;
+}
+
+template <class _Tp, std::size_t _Threshold>
+struct has_reallocate<mmap_allocator<_Tp, _Threshold> > : public true_type {};
+
+template <class _Tp, std::size_t _Threshold>
+struct has_allocate_zeroed<mmap_allocator<_Tp, _Threshold> > : public true_type {};
+
+template <class _Tp, std::size_t _Threshold>
+struct __has_trivial_construct<mmap_allocator<_Tp, _Threshold> > : public true_type {};
+
+} // namespace ft
+
+#endif // MMAP_ALLOCATOR_HPP
@@ -0,0 +1,410 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include <cstddef> // for size_t, ptrdiff_t
+#include <limits> // for numeric_limits
+#include <new> // for operator new, bad_alloc, placement new
+
+#include "__config.hpp"
+#include "type_traits.hpp"
+
+#if FT_CXX11
+#include <type_traits> // for true_type
+#endif
+
+namespace ft {
+
+// pool_stats
+
+/*
+** Snapshot of a pool
+**   slabs         : number of blocks obtained from operator new
+**   slab_bytes    : total size of those blocks
+**   chunks_in_use : chunks currently handed out by allocate(1)
+**   chunks_free   : chunks carved from the slabs that are not in use
+*/
+
+struct pool_stats {
+  std::size_t slabs;
+  std::size_t slab_bytes;
+  std::size_t chunks_in_use;
+  std::size_t chunks_free;
+};
+
+/*
+** Slabs are carved into chunks of a single size, fixed by the first single
+** object allocation. Freed chunks are kept in a free list threaded through
+** their own bytes and slabs are only returned when the last allocator sharing
+** the pool goes away.
+**
+** Q: Why do slabs grow?
+** A: Containers that stay small should not pay for a large slab, while big ones
+**    should get few, large slabs. The first slab holds 8 chunks and each next
+**    one doubles, up to kMaxSlabBytes.
+*/
+
+class __pool {
+ public:
+  static const std::size_t kFirstSlabChunks = 8;
+  static const std::size_t kMaxSlabBytes = 64 * 1024;
+
+  __pool()
+    : __refs_(1), __chunk_(0), __free_(NULL), __cur_(NULL), __end_(NULL),
+      __slabs_(NULL), __next_chunks_(kFirstSlabChunks) {
+    __stats_.slabs = 0;
+    __stats_.slab_bytes = 0;
+    __stats_.chunks_in_use = 0;
+    __stats_.chunks_free = 0;
+  }
+
+  ~__pool() {
+    while (__slabs_ != NULL) {
+      __slab* __next = __slabs_->__next_;
+      ::operator delete(static_cast<void*>(__slabs_));
+      __slabs_ = __next;
+    }
+  }
+
+  static void __retain(__pool* __p) {
+    if (__p != NULL) {
+      __add_refs(__p, 1);
+    }
+  }
+
+  static void __release(__pool* __p) {
+    if (__p != NULL && __add_refs(__p, -1) == 0) {
+      delete __p;
+    }
+  }
+
+  // Objects of __size bytes are served by the pool only if it is the chunk
+  // size, so allocate and deallocate take the same path for a given type
+
+  bool __serves(std::size_t __size) {
+    if (__chunk_ == 0) {
+      __chunk_ = __chunk_size(__size);
+    }
+    return __chunk_ == __chunk_size(__size);
+  }
+
+  void* __allocate() {
+    void* __p;
+    if (__free_ != NULL) {
+      __p = __free_;
+      __free_ = *static_cast<void**>(__p);
+    } else {
+      if (__cur_ == __end_) {
+        __grow();
+      }
+      __p = __cur_;
+      __cur_ += __chunk_;
+    }
+    ++__stats_.chunks_in_use;
+    --__stats_.chunks_free;
+    return __p;
+  }
+
+  void __deallocate(void* __p) {
+    *static_cast<void**>(__p) = __free_;
+    __free_ = __p;
+    --__stats_.chunks_in_use;
+    ++__stats_.chunks_free;
+  }
+
+  pool_stats __stats() const { return __stats_; }
+
+ private:
+  struct __slab {
+    __slab* __next_;
+  };
+
+  union __max_align {
+    long double __ld_;
+    double __d_;
+    long __l_;
+    void* __p_;
+  };
+
+  // Chunks must be able to hold the free list link and keep it aligned
+
+  static std::size_t __chunk_size(std::size_t __size) {
+    std::size_t __n = __size < sizeof(void*) ? sizeof(void*) : __size;
+    return (__n + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+  }
+
+  static std::size_t __header_size() {
+    return (sizeof(__slab) + sizeof(__max_align) - 1) / sizeof(__max_align) * sizeof(__max_align);
+  }
+
+  static std::size_t __add_refs(__pool* __p, long __n) {
+#if defined(__GNUC__)
+    return __sync_add_and_fetch(&__p->__refs_, static_cast<std::size_t>(__n));
+#else
+    return __p->__refs_ += static_cast<std::size_t>(__n);
+#endif
+  }
+
+  void __grow() {
+    std::size_t __n = __next_chunks_;
+    std::size_t __bytes = __header_size() + __n * __chunk_;
+    __slab* __s = static_cast<__slab*>(::operator new(__bytes));
+    __s->__next_ = __slabs_;
+    __slabs_ = __s;
+    __cur_ = reinterpret_cast<char*>(__s) + __header_size();
+    __end_ = __cur_ + __n * __chunk_;
+    if (__chunk_ * __n * 2 <= kMaxSlabBytes) {
+      __next_chunks_ = __n * 2;
+    }
+    ++__stats_.slabs;
+    __stats_.slab_bytes += __bytes;
+    __stats_.chunks_free += __n;
+  }
+
+  __pool(const __pool&);
+  __pool& operator=(const __pool&);
+
+  std::size_t __refs_;
+  std::size_t __chunk_;
+  void* __free_;
+  char* __cur_;
+  char* __end_;
+  __slab* __slabs_;
+  std::size_t __next_chunks_;
+  pool_stats __stats_;
+
+}; // class __pool
+
+/*
+** Handle of the pool shared by copies of an allocator
+**
+** Q: Why not create the pool with the first copy?
+** A: Containers copy their allocator when constructed, so an empty container
+**    would then allocate a pool it may never use. Handles copied from one
+**    without a pool instead join it in a ring, and the first of them asking
+**    for the pool creates it for the whole ring, which is then dissolved.
+**    Copying a handle links the copy to the original, so it has the same
+**    thread safety as the pool.
+*/
+
+class __pool_ref {
+ public:
+  __pool_ref() : __pool_(NULL), __prev_(this), __next_(this) {}
+
+  __pool_ref(const __pool_ref& __r) : __pool_(NULL), __prev_(this), __next_(this) {
+    __share(__r);
+  }
+
+  ~__pool_ref() { __leave(); }
+
+  __pool_ref& operator=(const __pool_ref& __r) {
+    if (this != &__r) {
+      __leave();
+      __share(__r);
+    }
+    return *this;
+  }
+
+  __pool* __get() const { return __pool_; }
+
+  __pool* __get_or_create() {
+    if (__pool_ == NULL) {
+      __pool* __p = new __pool();
+      for (const __pool_ref* __r = __next_; __r != this; ) {
+        const __pool_ref* __next = __r->__next_;
+        __pool::__retain(__p);
+        __r->__pool_ = __p;
+        __r->__prev_ = __r;
+        __r->__next_ = __r;
+        __r = __next;
+      }
+      __pool_ = __p;
+      __prev_ = this;
+      __next_ = this;
+    }
+    return __pool_;
+  }
+
+  // Handles share a pool, or will share the one any of them creates
+
+  bool __same(const __pool_ref& __r) const {
+    if (__pool_ != NULL || __r.__pool_ != NULL) {
+      return __pool_ == __r.__pool_;
+    }
+    const __pool_ref* __x = this;
+    do {
+      if (__x == &__r) {
+        return true;
+      }
+      __x = __x->__next_;
+    } while (__x != this);
+    return false;
+  }
+
+ private:
+  void __share(const __pool_ref& __r) {
+    if (__r.__pool_ != NULL) {
+      __pool::__retain(__r.__pool_);
+      __pool_ = __r.__pool_;
+    } else {
+      __prev_ = &__r;
+      __next_ = __r.__next_;
+      __r.__next_->__prev_ = this;
+      __r.__next_ = this;
+    }
+  }
+
+  void __leave() {
+    if (__pool_ != NULL) {
+      __pool::__release(__pool_);
+      __pool_ = NULL;
+    } else {
+      __prev_->__next_ = __next_;
+      __next_->__prev_ = __prev_;
+    }
+    __prev_ = this;
+    __next_ = this;
+  }
+
+  mutable __pool* __pool_;
+  mutable const __pool_ref* __prev_;
+  mutable const __pool_ref* __next_;
+
+}; // class __pool_ref
+
+/*
+** Allocator serving single objects from a pool of slabs, used by default for
+** the nodes of map and set
+**
+** Q: Who shares a pool?
+** A: Copies and rebound copies of an allocator share its pool, so the node
+**    allocator of a tree and the allocator returned by get_allocator() report
+**    the same stats. The pool is only created by the first allocation, so
+**    constructing, copying or swapping containers that stay empty allocates
+**    nothing, while copies made before it still share it (see __pool_ref) and
+**    can free each other's memory. Copying a container goes through
+**    select_on_container_copy_construction(), which starts a new pool, so two
+**    containers never share one.
+**
+** A pool is not synchronized: it has the same thread safety as the container
+** using it. Arrays (n != 1) are forwarded to operator new.
+*/
+
+template <class _Tp>
+class pool_allocator {
+ public:
+  typedef _Tp              value_type;
+  typedef _Tp*             pointer;
+  typedef const _Tp*       const_pointer;
+  typedef _Tp&             reference;
+  typedef const _Tp&       const_reference;
+  typedef std::size_t      size_type;
+  typedef std::ptrdiff_t   difference_type;
+
+#if FT_CXX11
+  typedef std::true_type   propagate_on_container_move_assignment;
+  typedef std::true_type   propagate_on_container_swap;
+#endif
+
+  template <class _Up>
+  struct rebind { typedef pool_allocator<_Up> other; };
+
+  template <class _Up> friend class pool_allocator;
+
+  pool_allocator() {}
+
+  pool_allocator(const pool_allocator& __a) : __pool_(__a.__pool_) {}
+
+  template <class _Up>
+  pool_allocator(const pool_allocator<_Up>& __a) : __pool_(__a.__pool_) {}
+
+  ~pool_allocator() {}
+
+  pool_allocator& operator=(const pool_allocator& __a) {
+    __pool_ = __a.__pool_;
+    return *this;
+  }
+
+  pool_allocator select_on_container_copy_construction() const {
+    return pool_allocator();
+  }
+
+  pointer address(reference __x) const { return &__x; }
+
+  const_pointer address(const_reference __x) const { return &__x; }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(value_type);
+  }
+
+  pointer allocate(size_type __n, const void* = 0) {
+    if (__n == 1) {
+      __pool* __p = __pool_.__get_or_create();
+      if (__p->__serves(sizeof(value_type))) {
+        return static_cast<pointer>(__p->__allocate());
+      }
+    } else if (max_size() < __n) {
+      throw std::bad_alloc();
+    }
+    return static_cast<pointer>(::operator new(__n * sizeof(value_type)));
+  }
+
+  void deallocate(pointer __p, size_type __n) {
+    __pool* __pl = __pool_.__get();
+    if (__n == 1 && __pl != NULL && __pl->__serves(sizeof(value_type))) {
+      __pl->__deallocate(static_cast<void*>(__p));
+    } else {
+      ::operator delete(static_cast<void*>(__p));
+    }
+  }
+
+  void construct(pointer __p, const_reference __v) {
+    ::new(static_cast<void*>(__p)) value_type(__v);
+  }
+
+  void destroy(pointer __p) { __p->~value_type(); }
+
+  pool_stats stats() const {
+    if (__pool_.__get() == NULL) {
+      pool_stats __s = {0, 0, 0, 0};
+      return __s;
+    }
+    return __pool_.__get()->__stats();
+  }
+
+  template <class _Up>
+  bool __same_pool(const pool_allocator<_Up>& __a) const {
+    return __pool_.__same(__a.__pool_);
+  }
+
+ private:
+  __pool_ref __pool_;
+
+}; // class pool_allocator
+
+template <class _T1, class _T2>
+bool operator==(const pool_allocator<_T1>& __x, const pool_allocator<_T2>& __y) {
+  return __x.__same_pool(__y);
+}
+
+template <class _T1, class _T2>
+bool operator!=(const pool_allocator<_T1>& __x, const pool_allocator<_T2>& __y) {
+  return !(__x == __y);
+}
+
+template <class _Tp>
+struct __has_trivial_construct<pool_allocator<_Tp> > : public true_type {};
+
+// Allocator for a copy of a container, as with
+// std::allocator_traits::select_on_container_copy_construction
+
+template <class _Allocator>
+_Allocator __select_on_copy(const _Allocator& __a) { return __a; }
+
+template <class _Tp>
+pool_allocator<_Tp> __select_on_copy(const pool_allocator<_Tp>& __a) {
+  return __a.select_on_container_copy_construction();
+}
+
+} // namespace ft
+
+#endif // POOL_ALLOCATOR_HPP
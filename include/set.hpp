@@ -2,16 +2,18 @@
 #define SET_HPP
 
 #include <functional> // for less
-#include <memory> // for allocator
 
 #include "utility.hpp" // for ft::pair
 #include "type_traits.hpp" // for __select_first
+#include "pool_allocator.hpp"
+#include "tree_policy.hpp"
 #include "__tree.hpp"
 
 namespace ft {
 
 template <class _Key, class _Compare = std::less<_Key>,
-          class _Allocator = std::allocator<_Key> >
+          class _Allocator = ft::pool_allocator<_Key>,
+          class _TreePolicy = ft::tree_plain>
 class set {
  public:
 
@@ -20,6 +22,7 @@ class set {
   typedef _Compare                                           key_compare;
   typedef key_compare                                        value_compare;
   typedef _Allocator                                         allocator_type;
+  typedef _TreePolicy                                        tree_policy;
   typedef typename allocator_type::reference                 reference;
   typedef typename allocator_type::const_reference           const_reference;
   typedef typename allocator_type::pointer                   pointer;
@@ -31,7 +34,8 @@ class set {
 
   typedef ft::__tree<ft::__tree_traits<key_type, value_type,
                                        ft::__identity<value_type>,
-                                       key_compare, allocator_type> > __base;
+                                       key_compare, allocator_type,
+                                       tree_policy> > __base;
 
   __base __tree_;
 
@@ -40,6 +44,7 @@ class set {
   typedef typename __base::const_iterator                    const_iterator;
   typedef typename __base::reverse_iterator                  reverse_iterator;
   typedef typename __base::const_reverse_iterator            const_reverse_iterator;
+  typedef typename __base::aggregate_type                    aggregate_type;
 
   set() : __tree_(key_compare(), allocator_type()) {}
 
@@ -57,6 +62,14 @@ class set {
     insert(__f, __l);
   }
 
+  template <class _InputIterator>
+  set(ft::sorted_unique_t, _InputIterator __f, _InputIterator __l,
+      const key_compare& __comp = key_compare(),
+      const allocator_type& __a = allocator_type())
+    : __tree_(__comp, __a) {
+    __tree_.insert_sorted_unique(__f, __l);
+  }
+
   set(const set& __m) : __tree_(__m.__tree_) {}
 
   ~set() {}
@@ -68,6 +81,15 @@ class set {
     return *this;
   }
 
+#if FT_CXX11
+  set(set&& __m) : __tree_(std::move(__m.__tree_)) {}
+
+  set& operator=(set&& __m) {
+    __tree_ = std::move(__m.__tree_);
+    return *this;
+  }
+#endif
+
   // Iterators
 
   iterator begin() { return __tree_.begin(); }
@@ -94,6 +116,10 @@ class set {
 
   size_type max_size() const { return __tree_.max_size(); }
 
+  size_type capacity() const { return __tree_.capacity(); }
+
+  void reserve(size_type __n) { __tree_.reserve(__n); }
+
   // Modifiers
 
   ft::pair<iterator, bool> insert(const value_type& __v) {
@@ -104,12 +130,37 @@ class set {
     return __tree_.insert(__it, __v);
   }
 
+#if FT_CXX11
+  ft::pair<iterator, bool> insert(value_type&& __v) {
+    return __tree_.emplace(std::move(__v));
+  }
+
+  iterator insert(iterator __it, value_type&& __v) {
+    return __tree_.emplace_hint(__it, std::move(__v));
+  }
+
+  template <class... _Args>
+  ft::pair<iterator, bool> emplace(_Args&&... __args) {
+    return __tree_.emplace(std::forward<_Args>(__args)...);
+  }
+
+  template <class... _Args>
+  iterator emplace_hint(iterator __it, _Args&&... __args) {
+    return __tree_.emplace_hint(__it, std::forward<_Args>(__args)...);
+  }
+#endif
+
   template <class _InputIterator>
   typename ft::enable_if<!ft::is_integral<_InputIterator>::value, void>::type
   insert(_InputIterator __first, _InputIterator __last) {
     __tree_.insert(__first, __last);
   }
 
+  template <class _InputIterator>
+  void insert(ft::sorted_unique_t, _InputIterator __first, _InputIterator __last) {
+    __tree_.insert_sorted_unique(__first, __last);
+  }
+
   void erase(iterator __p) {
     __tree_.erase(__p);
   }
@@ -118,6 +169,12 @@ class set {
     return __tree_.erase(__k);
   }
 
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, size_type>::type
+  erase(const _K2& __k) {
+    return __tree_.erase(__k);
+  }
+
   void erase(iterator __first, iterator __last) {
     __tree_.erase(__first, __last);
   }
@@ -126,6 +183,10 @@ class set {
 
   void clear() { __tree_.clear(); }
 
+  // Like clear(), but the nodes are kept for the next insertions
+
+  void clear_keep_capacity() { __tree_.clear_keep_capacity(); }
+
   // Observers
 
   key_compare key_comp() const { return __tree_.key_comp(); }
@@ -156,65 +217,129 @@ class set {
     return __tree_.equal_range(__k);
   }
 
+  // Lookups by keys of another type, when key_compare is transparent
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  find(const _K2& __k) { return __tree_.find(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  find(const _K2& __k) const { return __tree_.find(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, size_type>::type
+  count(const _K2& __k) const { return __tree_.count(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  lower_bound(const _K2& __k) { return __tree_.lower_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  lower_bound(const _K2& __k) const { return __tree_.lower_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, iterator>::type
+  upper_bound(const _K2& __k) { return __tree_.upper_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value, const_iterator>::type
+  upper_bound(const _K2& __k) const { return __tree_.upper_bound(__k); }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value,
+                         ft::pair<iterator, iterator> >::type
+  equal_range(const _K2& __k) {
+    return __tree_.equal_range(__k);
+  }
+
+  template <class _K2>
+  typename ft::enable_if<ft::__is_transparent<key_compare, _K2>::value,
+                         ft::pair<const_iterator, const_iterator> >::type
+  equal_range(const _K2& __k) const {
+    return __tree_.equal_range(__k);
+  }
+
+  // Order statistics, only with a tree_order_statistic policy
+
+  iterator nth(size_type __k) { return __tree_.nth(__k); }
+
+  const_iterator nth(size_type __k) const { return __tree_.nth(__k); }
+
+  size_type rank(const key_type& __k) const { return __tree_.rank(__k); }
+
+  // Range aggregates, only with a tree_aggregate policy. aggregate(__lo, __hi)
+  // combines the values of the keys from __lo to __hi, both included
+
+  aggregate_type aggregate() const { return __tree_.aggregate(); }
+
+  aggregate_type aggregate(const key_type& __lo, const key_type& __hi) const {
+    return __tree_.aggregate(__lo, __hi);
+  }
+
   // Allocator
 
   allocator_type get_allocator() const { return __tree_.get_allocator(); }
 
   // Non-member functions
-  template <class _K1, class _C1, class _A1>
-  friend bool operator==(const set<_K1, _C1, _A1>& __x,
-                         const set<_K1, _C1, _A1>& __y);
+  template <class _K1, class _C1, class _A1, class _P1>
+  friend bool operator==(const set<_K1, _C1, _A1, _P1>& __x,
+                         const set<_K1, _C1, _A1, _P1>& __y);
 
-  template <class _K1, class _C1, class _A1>
-  friend bool operator< (const set<_K1, _C1, _A1>& __x,
-                         const set<_K1, _C1, _A1>& __y);
+  template <class _K1, class _C1, class _A1, class _P1>
+  friend bool operator< (const set<_K1, _C1, _A1, _P1>& __x,
+                         const set<_K1, _C1, _A1, _P1>& __y);
 
 };
 
 // Non-member functions
 
-template <class _Key, class _Compare, class _Allocator>
-bool operator==(const set<_Key, _Compare, _Allocator>& __x,
-                       const set<_Key, _Compare, _Allocator>& __y) {
+template <class _Key, class _Compare, class _Allocator, class _TreePolicy>
+bool operator==(const set<_Key, _Compare, _Allocator, _TreePolicy>& __x,
+                       const set<_Key, _Compare, _Allocator, _TreePolicy>& __y) {
   return __x.__tree_ == __y.__tree_;
 }
 
-template <class _Key, class _Compare, class _Allocator>
-inline bool operator!=(const set<_Key, _Compare, _Allocator>& __x,
-                       const set<_Key, _Compare, _Allocator>& __y) {
+template <class _Key, class _Compare, class _Allocator, class _TreePolicy>
+inline bool operator!=(const set<_Key, _Compare, _Allocator, _TreePolicy>& __x,
+                       const set<_Key, _Compare, _Allocator, _TreePolicy>& __y) {
   return !(__x == __y);
 }
 
-template <class _Key, class _Compare, class _Allocator>
-bool operator<(const set<_Key, _Compare, _Allocator>& __x,
-                      const set<_Key, _Compare, _Allocator>& __y) {
+template <class _Key, class _Compare, class _Allocator, class _TreePolicy>
+bool operator<(const set<_Key, _Compare, _Allocator, _TreePolicy>& __x,
+                      const set<_Key, _Compare, _Allocator, _TreePolicy>& __y) {
   return __x.__tree_ < __y.__tree_;
 }
 
-template <class _Key, class _Compare, class _Allocator>
-inline bool operator>(const set<_Key, _Compare, _Allocator>& __x,
-                      const set<_Key, _Compare, _Allocator>& __y) {
+template <class _Key, class _Compare, class _Allocator, class _TreePolicy>
+inline bool operator>(const set<_Key, _Compare, _Allocator, _TreePolicy>& __x,
+                      const set<_Key, _Compare, _Allocator, _TreePolicy>& __y) {
   return __y < __x;
 }
 
-template <class _Key, class _Compare, class _Allocator>
-inline bool operator<=(const set<_Key, _Compare, _Allocator>& __x,
-                       const set<_Key, _Compare, _Allocator>& __y) {
+template <class _Key, class _Compare, class _Allocator, class _TreePolicy>
+inline bool operator<=(const set<_Key, _Compare, _Allocator, _TreePolicy>& __x,
+                       const set<_Key, _Compare, _Allocator, _TreePolicy>& __y) {
   return !(__y < __x);
 }
 
-template <class _Key, class _Compare, class _Allocator>
-inline bool operator>=(const set<_Key, _Compare, _Allocator>& __x,
-                       const set<_Key, _Compare, _Allocator>& __y) {
+template <class _Key, class _Compare, class _Allocator, class _TreePolicy>
+inline bool operator>=(const set<_Key, _Compare, _Allocator, _TreePolicy>& __x,
+                       const set<_Key, _Compare, _Allocator, _TreePolicy>& __y) {
   return !(__x < __y);
 }
 
-template <class _Key, class _Compare, class _Allocator>
-inline void swap(set<_Key, _Compare, _Allocator>& __x,
-                 set<_Key, _Compare, _Allocator>& __y) {
+template <class _Key, class _Compare, class _Allocator, class _TreePolicy>
+inline void swap(set<_Key, _Compare, _Allocator, _TreePolicy>& __x,
+                 set<_Key, _Compare, _Allocator, _TreePolicy>& __y) {
   __x.swap(__y);
 }
 
+template <class _Key, class _Compare, class _Allocator, class _TreePolicy>
+struct is_swap_relocatable<set<_Key, _Compare, _Allocator, _TreePolicy> > : public true_type {};
+
 }
 
 #endif // SET_HPP
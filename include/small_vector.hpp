@@ -0,0 +1,834 @@
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include <memory> // for allocator
+#include <algorithm> // for copy, fill, min, rotate, swap_ranges
+#include <stdexcept> // for out_of_range and length_error
+#include <limits> // for numeric_limits
+#include <cstddef> // for size_t
+#include <cstring> // for memmove
+
+#include "__config.hpp"
+
+#if FT_CXX11
+#include <utility> // for move, forward
+#include <type_traits> // for is_nothrow_move_constructible
+#endif
+
+#include "iterator.hpp"
+#include "vector_iterator.hpp"
+#include "iterator_traits.hpp"
+#include "type_traits.hpp"
+#include "algorithm.hpp"
+#include "growth_policy.hpp"
+
+namespace ft {
+
+/*
+** A vector that keeps up to _N elements inside the object itself and only
+** allocates from _Allocator once it grows past them. The interface and the
+** iterator type are those of ft::vector.
+**
+** Q: What is different from ft::vector?
+** A: - capacity() is never below _N
+**    - Iterators and references into the inline buffer are invalidated by
+**      swap as well, since elements have to be moved between objects
+**    - Elements must not require an alignment stricter than long double
+*/
+
+template <class _Tp, std::size_t _N, class _Allocator = std::allocator<_Tp>,
+          class _GrowthPolicy = ft::growth_doubling>
+class small_vector {
+
+ public:
+  typedef _Tp                                           value_type;
+  typedef _Allocator                                    allocator_type;
+  typedef _GrowthPolicy                                 growth_policy;
+  typedef typename allocator_type::reference            reference;
+  typedef typename allocator_type::const_reference      const_reference;
+  typedef typename allocator_type::pointer              pointer;
+  typedef typename allocator_type::const_pointer        const_pointer;
+  typedef typename ft::vector_iterator<pointer>         iterator;
+  typedef typename ft::vector_iterator<const_pointer>   const_iterator;
+  typedef typename ft::reverse_iterator<iterator>       reverse_iterator;
+  typedef typename ft::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef typename allocator_type::difference_type      difference_type;
+  typedef typename allocator_type::size_type            size_type;
+
+  static const size_type inline_capacity = _N;
+
+ private:
+  pointer __begin_;
+  pointer __end_;
+  pointer __end_cap_;
+  allocator_type __alloc_;
+
+  // The union aligns the raw bytes for any fundamental type
+
+  union __storage {
+    char __buf_[(_N == 0 ? 1 : _N) * sizeof(_Tp)];
+    long double __ld_;
+    double __d_;
+    long __l_;
+    void* __p_;
+  } __storage_;
+
+  typedef ft::integral_constant<bool,
+      ft::is_bitwise_copyable<value_type>::value
+      && ft::__has_trivial_construct<allocator_type>::value>  __bitwise_copy_tag;
+  typedef ft::integral_constant<bool,
+      ft::is_trivially_destructible<value_type>::value
+      && ft::__has_trivial_construct<allocator_type>::value>  __trivial_destroy_tag;
+
+  // Elements are relocated as vector does it: bitwise, by a move that cannot
+  // throw since C++11, or by swapping them into default-constructed ones
+
+#if FT_CXX11
+  typedef ft::integral_constant<bool,
+      !__bitwise_copy_tag::value
+      && std::is_nothrow_move_constructible<value_type>::value> __move_relocate_tag;
+#else
+  typedef ft::false_type                                      __move_relocate_tag;
+#endif
+
+  typedef ft::integral_constant<bool,
+      ft::is_swap_relocatable<value_type>::value
+      && !__bitwise_copy_tag::value
+      && !__move_relocate_tag::value>                        __swap_relocate_tag;
+
+  template <class _Iterator>
+  struct __bitwise_range_tag
+    : public ft::integral_constant<bool,
+        __bitwise_copy_tag::value
+        && ft::__is_contiguous_iterator<_Iterator, value_type>::value> {};
+
+ public:
+
+  // Default constructor
+
+  explicit small_vector(const allocator_type& __a = allocator_type())
+    : __alloc_(__a) {
+    __init();
+  }
+
+  // Fill constructor
+
+  small_vector(size_type __n, const_reference __x = value_type(),
+               const allocator_type& __a = allocator_type())
+    : __alloc_(__a) {
+    __init();
+    insert(end(), __n, __x);
+  }
+
+  // Range constructor
+
+  template <class _Iterator>
+  small_vector(_Iterator __first, _Iterator __last,
+               const allocator_type& __a = allocator_type(),
+               typename ft::enable_if<!ft::is_integral<_Iterator>::value>::type* = NULL)
+    : __alloc_(__a) {
+    __init();
+    insert(end(), __first, __last);
+  }
+
+  // Copy constructor
+
+  small_vector(const small_vector& __x) : __alloc_(__x.__alloc_) {
+    __init();
+    insert(end(), __x.begin(), __x.end());
+  }
+
+#if FT_CXX11
+  // Move constructor
+  // A heap buffer is taken over, inline elements are moved one by one
+
+  small_vector(small_vector&& __x) : __alloc_(std::move(__x.__alloc_)) {
+    __init();
+    __take(__x);
+  }
+#endif
+
+  // Destructor
+
+  ~small_vector() {
+    __release();
+  }
+
+  // Assignation operator
+
+  small_vector& operator=(const small_vector& __x) {
+    if (this != &__x) {
+      if (__x.size() <= size()) {
+        pointer __new_end = __copy(__x.begin(), __x.end(), __begin_);
+        __destroy(__new_end, __end_);
+        __end_ = __new_end;
+      } else if (__x.size() <= capacity()) {
+        const_iterator __s = __x.begin() + size();
+        __copy(__x.begin(), __s, __begin_);
+        __end_ = __construct_to_copy(__s, __x.end(), __end_);
+      } else {
+        clear();
+        __reallocate(__x.size());
+        __end_ = __construct_to_copy(__x.begin(), __x.end(), __begin_);
+      }
+    }
+    return *this;
+  }
+
+#if FT_CXX11
+  small_vector& operator=(small_vector&& __x) {
+    if (this != &__x) {
+      __release();
+      swap(__x);
+    }
+    return *this;
+  }
+#endif
+
+  // Iterators
+
+  iterator begin() { return iterator(__begin_); }
+
+  const_iterator begin() const { return const_iterator(__begin_); }
+
+  iterator end() { return iterator(__end_); }
+
+  const_iterator end() const { return const_iterator(__end_); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  // Capacity
+
+  size_type size() const {
+    return static_cast<size_type>(__end_ - __begin_);
+  }
+
+  size_type max_size() const {
+    return std::min<size_type>(__alloc_.max_size(),
+                               std::numeric_limits<difference_type>::max());
+  }
+
+  void resize(size_type __sz, value_type __val = value_type()) {
+    size_type __cs = size();
+    if (__cs < __sz) {
+      insert(end(), __sz - __cs, __val);
+    } else if (__sz < __cs) {
+      erase(begin() + __sz, end());
+    }
+  }
+
+  size_type capacity() const {
+    return static_cast<size_type>(__end_cap_ - __begin_);
+  }
+
+  bool empty() const {
+    return __begin_ == __end_;
+  }
+
+  void reserve(size_type __n) {
+    if (max_size() < __n) {
+      __throw_length_error();
+    } else if (capacity() < __n) {
+      __reallocate(__n);
+    }
+  }
+
+  // Returns true while the elements live in the inline buffer
+
+  bool is_inline() const {
+    return __begin_ == __inline_begin();
+  }
+
+  // Element access
+
+  reference operator [](size_type __n) { return __begin_[__n]; }
+
+  const_reference operator [](size_type __n) const { return __begin_[__n]; }
+
+  reference at(size_type __n) {
+    if (size() <= __n) {
+      __throw_out_of_range();
+    }
+    return __begin_[__n];
+  }
+
+  const_reference at(size_type __n) const {
+    if (size() <= __n) {
+      __throw_out_of_range();
+    }
+    return __begin_[__n];
+  }
+
+  reference front() { return *__begin_; }
+
+  const_reference front() const { return *__begin_; }
+
+  reference back() { return *(__end_ - 1); }
+
+  const_reference back() const { return *(__end_ - 1); }
+
+  // Modifiers
+
+  template <class _Iterator>
+  typename ft::enable_if<!ft::is_integral<_Iterator>::value, void>::type
+  assign(_Iterator __first, _Iterator __last) {
+    clear();
+    insert(begin(), __first, __last);
+  }
+
+  void assign(size_type __n, const value_type& __val) {
+    clear();
+    insert(begin(), __n, __val);
+  }
+
+  void push_back(const value_type& __val) {
+    if (__end_ != __end_cap_) {
+      __alloc_.construct(__end_, __val);
+      ++__end_;
+    } else {
+      insert(end(), __val);
+    }
+  }
+
+  void pop_back() { erase(end() - 1); }
+
+#if FT_CXX11
+  void push_back(value_type&& __val) { emplace_back(std::move(__val)); }
+
+  template <class... _Args>
+  void emplace_back(_Args&&... __args) {
+    size_type __s = size();
+    if (__end_ != __end_cap_) {
+      __construct(__end_, std::forward<_Args>(__args)...);
+      ++__end_;
+    } else if (max_size() == __s) {
+      __throw_length_error();
+    } else {
+      size_type __cap = __recommend(__s + 1);
+      pointer __new_begin = __alloc_.allocate(__cap);
+      try {
+        __construct(__new_begin + __s, std::forward<_Args>(__args)...);
+      } catch (...) {
+        __alloc_.deallocate(__new_begin, __cap);
+        throw;
+      }
+      __relocate_to(__new_begin, __cap, __end_, 1);
+    }
+  }
+
+  template <class... _Args>
+  iterator emplace(iterator __position, _Args&&... __args) {
+    difference_type __off = __position - begin();
+    emplace_back(std::forward<_Args>(__args)...);
+    std::rotate(begin() + __off, end() - 1, end());
+    return begin() + __off;
+  }
+
+  iterator insert(iterator __position, value_type&& __val) {
+    return emplace(__position, std::move(__val));
+  }
+#endif
+
+  iterator insert(iterator __position, const value_type& __val) {
+    size_type __off = __position - begin();
+    insert(__position, static_cast<size_type>(1), __val);
+    return begin() + __off;
+  }
+
+  void insert(iterator __position, size_type __n, const value_type& __x) {
+    size_type __s = size();
+    if (__n == 0) {
+      ;
+    } else if (max_size() - __s < __n) {
+      __throw_length_error();
+    } else if (capacity() < __s + __n) {
+      size_type __cap = __recommend(__s + __n);
+      pointer __new_begin = __alloc_.allocate(__cap);
+      pointer __new_pos = __new_begin + (__position - begin());
+      try {
+        __construct_to_fill(__new_pos, __n, __x);
+      } catch (...) {
+        __alloc_.deallocate(__new_begin, __cap);
+        throw;
+      }
+      __relocate_to(__new_begin, __cap, __position.base(), __n);
+    } else if (static_cast<size_type>(end() - __position) < __n) {
+      value_type __v = __x;
+      pointer __p = __position.base();
+      __construct_to_copy(__p, __end_, __p + __n);
+      try {
+        __construct_to_fill(__end_, __n - static_cast<size_type>(__end_ - __p), __v);
+      } catch (...) {
+        __destroy(__p + __n, __end_ + __n);
+        throw;
+      }
+      std::fill(__p, __end_, __v);
+      __end_ += __n;
+    } else {
+      value_type __v = __x;
+      pointer __old_end = __end_;
+      __end_ = __construct_to_copy(__old_end - __n, __old_end, __end_);
+      __copy_backward(__position.base(), __old_end - __n, __old_end);
+      std::fill(__position.base(), __position.base() + __n, __v);
+    }
+  }
+
+  template <class _InputIterator>
+  typename ft::enable_if<!ft::is_integral<_InputIterator>::value, void>::type
+  insert(iterator __position, _InputIterator __first, _InputIterator __last) {
+    __insert_range(__position, __first, __last,
+                   typename ft::iterator_traits<_InputIterator>::iterator_category());
+  }
+
+  iterator erase(iterator __position) {
+    __copy(__position + 1, end(), __position.base());
+    __destroy(__end_ - 1, __end_);
+    --__end_;
+    return __position;
+  }
+
+  iterator erase(iterator __first, iterator __last) {
+    if (__first != __last) {
+      pointer __new_end = __copy(__last, end(), __first.base());
+      __destroy(__new_end, __end_);
+      __end_ = __new_end;
+    }
+    return __first;
+  }
+
+  /*
+  ** Q: Why not just swap the pointers like vector does?
+  ** A: Pointers into an inline buffer would end up pointing into the other
+  **    object. Only two heap buffers can be exchanged. A heap buffer changes
+  **    hands after the inline elements of the other side are relocated out of
+  **    the way, and two inline buffers swap their common elements, then the
+  **    longer one relocates its tail. The allocators are always exchanged,
+  **    each going with the heap buffer it allocated
+  */
+
+  void swap(small_vector& __x) {
+    if (this == &__x) {
+      ;
+    } else if (!is_inline() && !__x.is_inline()) {
+      ft::swap(__begin_, __x.__begin_);
+      ft::swap(__end_, __x.__end_);
+      ft::swap(__end_cap_, __x.__end_cap_);
+    } else if (!is_inline()) {
+      __give_buffer(__x);
+    } else if (!__x.is_inline()) {
+      __x.__give_buffer(*this);
+    } else if (size() < __x.size()) {
+      __swap_inline(__x);
+    } else {
+      __x.__swap_inline(*this);
+    }
+    ft::swap(__alloc_, __x.__alloc_);
+  }
+
+  void clear() {
+    __destroy(__begin_, __end_);
+    __end_ = __begin_;
+  }
+
+  // Allocator
+
+  allocator_type get_allocator() const {
+    return __alloc_;
+  }
+
+ private :
+
+  // Helper functions
+
+  pointer __inline_begin() const {
+    return reinterpret_cast<pointer>(const_cast<char*>(__storage_.__buf_));
+  }
+
+  void __init() {
+    __begin_ = __end_ = __inline_begin();
+    __end_cap_ = __begin_ + _N;
+  }
+
+  // Destroys every element and gives the heap buffer, if any, back
+
+  void __release() {
+    __destroy(__begin_, __end_);
+    if (!is_inline()) {
+      __alloc_.deallocate(__begin_, capacity());
+    }
+    __init();
+  }
+
+  // Takes ownership of a heap buffer already holding __sz elements
+
+  void __replace_buffer(pointer __new_begin, size_type __sz, size_type __cap) {
+    __release();
+    __begin_ = __new_begin;
+    __end_ = __new_begin + __sz;
+    __end_cap_ = __new_begin + __cap;
+  }
+
+  void __reallocate(size_type __n) {
+    __relocate_to(__alloc_.allocate(__n), __n, __end_, 0);
+  }
+
+  /*
+  ** Moves the elements into __new_begin, a heap buffer of __cap in which __n
+  ** elements have already been constructed where __position will land, then
+  ** adopts it
+  ** If anything throws, the small_vector is left unchanged and the buffer
+  ** and its new elements are released
+  */
+
+  void __relocate_to(pointer __new_begin, size_type __cap, pointer __position, size_type __n) {
+    pointer __new_pos = __new_begin + (__position - __begin_);
+    try {
+      __relocate(__begin_, __position, __new_begin);
+      try {
+        __relocate(__position, __end_, __new_pos + __n);
+      } catch (...) {
+        __unrelocate(__new_begin, __new_pos, __begin_);
+        throw;
+      }
+    } catch (...) {
+      __destroy(__new_pos, __new_pos + __n);
+      __alloc_.deallocate(__new_begin, __cap);
+      throw;
+    }
+    __replace_buffer(__new_begin, size() + __n, __cap);
+  }
+
+  // Constructs [__first, __last) into raw storage at __result, see vector
+
+  pointer __relocate(pointer __first, pointer __last, pointer __result) {
+    return __relocate(__first, __last, __result, __swap_relocate_tag());
+  }
+
+  pointer __relocate(pointer __first, pointer __last, pointer __result, ft::false_type) {
+#if FT_CXX11
+    if (__move_relocate_tag::value) {
+      return __construct_to_copy(std::make_move_iterator(__first),
+                                 std::make_move_iterator(__last), __result);
+    }
+#endif
+    return __construct_to_copy(__first, __last, __result);
+  }
+
+  pointer __relocate(pointer __first, pointer __last, pointer __result, ft::true_type) {
+    pointer __old_first = __first;
+    pointer __old_result = __result;
+    try {
+      for (; __first != __last; ++__first, ++__result) {
+        __alloc_.construct(__result, value_type());
+        __result->swap(*__first);
+      }
+    } catch (...) {
+      __unrelocate(__old_result, __result, __old_first);
+      throw;
+    }
+    return __result;
+  }
+
+  // Undoes __relocate of the elements now in [__first, __last) back to __result
+
+  void __unrelocate(pointer __first, pointer __last, pointer __result) {
+    __unrelocate(__first, __last, __result, __swap_relocate_tag());
+  }
+
+  void __unrelocate(pointer __first, pointer __last, pointer __result, ft::false_type) {
+#if FT_CXX11
+    if (__move_relocate_tag::value) {
+      for (pointer __p = __first; __p != __last; ++__p, ++__result) {
+        __alloc_.destroy(__result);
+        __construct(__result, std::move(*__p));
+      }
+    }
+#endif
+    (void)__result;
+    __destroy(__first, __last);
+  }
+
+  void __unrelocate(pointer __first, pointer __last, pointer __result, ft::true_type) {
+    for (pointer __p = __first; __p != __last; ++__p, ++__result) {
+      __p->swap(*__result);
+    }
+    __destroy(__first, __last);
+  }
+
+  // Hands the heap buffer of *this to __x, whose inline elements come here
+  // If relocating them throws, neither object is changed
+
+  void __give_buffer(small_vector& __x) {
+    pointer __begin = __begin_;
+    pointer __end = __end_;
+    pointer __end_cap = __end_cap_;
+    __init();
+    try {
+      __end_ = __relocate(__x.__begin_, __x.__end_, __begin_);
+    } catch (...) {
+      __begin_ = __begin;
+      __end_ = __end;
+      __end_cap_ = __end_cap;
+      throw;
+    }
+    __x.clear();
+    __x.__begin_ = __begin;
+    __x.__end_ = __end;
+    __x.__end_cap_ = __end_cap;
+  }
+
+  // Swaps two inline buffers, __x holding more elements than *this
+
+  void __swap_inline(small_vector& __x) {
+    pointer __mid = __x.__begin_ + size();
+    __end_ = __relocate(__mid, __x.__end_, __end_);
+    __x.__destroy(__mid, __x.__end_);
+    __x.__end_ = __mid;
+    std::swap_ranges(__begin_, __begin_ + __x.size(), __x.__begin_);
+  }
+
+#if FT_CXX11
+  template <class... _Args>
+  void __construct(pointer __p, _Args&&... __args) {
+    std::allocator_traits<allocator_type>::construct(__alloc_, __p,
+                                                     std::forward<_Args>(__args)...);
+  }
+
+  // Leaves __x empty, expects *this to be empty and inline
+
+  void __take(small_vector& __x) {
+    if (__x.is_inline()) {
+      __end_ = __construct_to_copy(std::make_move_iterator(__x.__begin_),
+                                   std::make_move_iterator(__x.__end_), __begin_);
+      __x.clear();
+    } else {
+      __begin_ = __x.__begin_;
+      __end_ = __x.__end_;
+      __end_cap_ = __x.__end_cap_;
+      __x.__init();
+    }
+  }
+#endif
+
+  size_type __recommend(size_type __new_size) const {
+    size_type __cap = growth_policy::recommend(capacity(), __new_size, max_size(),
+                                               sizeof(value_type));
+    return __cap < __new_size ? __new_size : __cap;
+  }
+
+  void __destroy(pointer __begin, pointer __end) {
+    __destroy(__begin, __end, __trivial_destroy_tag());
+  }
+
+  void __destroy(pointer, pointer, ft::true_type) {}
+
+  void __destroy(pointer __begin, pointer __end, ft::false_type) {
+    for (; __begin != __end; ++__begin) {
+      __alloc_.destroy(__begin);
+    }
+  }
+
+  pointer __construct_to_fill(pointer __end, size_type __n, const_reference __x) {
+    pointer __old_end = __end;
+    try {
+      for (; 0 < __n; --__n, ++__end) {
+        __alloc_.construct(__end, __x);
+      }
+    } catch (...) {
+      __destroy(__old_end, __end);
+      throw;
+    }
+    return __end;
+  }
+
+  template <class _ForwardIterator>
+  pointer __construct_to_copy(_ForwardIterator __first, _ForwardIterator __last, pointer __end) {
+    return __construct_to_copy(__first, __last, __end,
+                               __bitwise_range_tag<_ForwardIterator>());
+  }
+
+  template <class _ForwardIterator>
+  pointer __construct_to_copy(_ForwardIterator __first, _ForwardIterator __last, pointer __end,
+                              ft::true_type) {
+    return __bitwise_copy(__first, __last, __end);
+  }
+
+  template <class _ForwardIterator>
+  pointer __construct_to_copy(_ForwardIterator __first, _ForwardIterator __last, pointer __end,
+                              ft::false_type) {
+    pointer __old_end = __end;
+    try {
+      for (; __first != __last; ++__end, ++__first) {
+        __alloc_.construct(__end, *__first);
+      }
+    } catch (...) {
+      __destroy(__old_end, __end);
+      throw;
+    }
+    return __end;
+  }
+
+  template <class _Iterator>
+  pointer __copy(_Iterator __first, _Iterator __last, pointer __result) {
+    return __copy(__first, __last, __result, __bitwise_range_tag<_Iterator>());
+  }
+
+  template <class _Iterator>
+  pointer __copy(_Iterator __first, _Iterator __last, pointer __result, ft::true_type) {
+    return __bitwise_copy(__first, __last, __result);
+  }
+
+  template <class _Iterator>
+  pointer __copy(_Iterator __first, _Iterator __last, pointer __result, ft::false_type) {
+    return std::copy(__first, __last, __result);
+  }
+
+  void __copy_backward(pointer __first, pointer __last, pointer __result) {
+    __copy_backward(__first, __last, __result, __bitwise_copy_tag());
+  }
+
+  void __copy_backward(pointer __first, pointer __last, pointer __result, ft::true_type) {
+    __bitwise_copy(__first, __last, __result - (__last - __first));
+  }
+
+  void __copy_backward(pointer __first, pointer __last, pointer __result, ft::false_type) {
+    std::copy_backward(__first, __last, __result);
+  }
+
+  template <class _Iterator>
+  pointer __bitwise_copy(_Iterator __first, _Iterator __last, pointer __result) {
+    size_type __n = static_cast<size_type>(__last - __first);
+    if (__n != 0) {
+      std::memmove(static_cast<void*>(__result), static_cast<const void*>(&*__first),
+                   __n * sizeof(value_type));
+    }
+    return __result + __n;
+  }
+
+  void __throw_length_error() const {
+    throw std::length_error("small_vector");
+  }
+
+  void __throw_out_of_range() const {
+    throw std::out_of_range("small_vector");
+  }
+
+  // The length of an input range is unknown before reading it, so its elements
+  // are appended, with amortized reallocations, then rotated into place
+
+  template <class _Iterator>
+  void __insert_range(iterator __position, _Iterator __first, _Iterator __last,
+                      std::input_iterator_tag) {
+    difference_type __off = __position - begin();
+    size_type __old_size = size();
+    try {
+      for (; __first != __last; ++__first) {
+        push_back(*__first);
+      }
+    } catch (...) {
+      erase(begin() + __old_size, end());
+      throw;
+    }
+    std::rotate(begin() + __off, begin() + __old_size, end());
+  }
+
+  template <class _Iterator>
+  void __insert_range(iterator __position, _Iterator __first, _Iterator __last,
+                      std::forward_iterator_tag) {
+    size_type __n = static_cast<size_type>(ft::distance(__first, __last));
+    size_type __s = size();
+    if (__n == 0) {
+      ;
+    } else if (max_size() - __s < __n) {
+      __throw_length_error();
+    } else if (capacity() < __s + __n) {
+      size_type __cap = __recommend(__s + __n);
+      pointer __new_begin = __alloc_.allocate(__cap);
+      pointer __new_pos = __new_begin + (__position - begin());
+      try {
+        __construct_to_copy(__first, __last, __new_pos);
+      } catch (...) {
+        __alloc_.deallocate(__new_begin, __cap);
+        throw;
+      }
+      __relocate_to(__new_begin, __cap, __position.base(), __n);
+    } else if (static_cast<size_type>(end() - __position) < __n) {
+      pointer __p = __position.base();
+      __construct_to_copy(__p, __end_, __p + __n);
+      _Iterator __middle = __first;
+      ft::advance(__middle, __end_ - __p);
+      try {
+        __construct_to_copy(__middle, __last, __end_);
+      } catch (...) {
+        __destroy(__p + __n, __end_ + __n);
+        throw;
+      }
+      __end_ += __n;
+      __copy(__first, __middle, __p);
+    } else {
+      pointer __old_end = __end_;
+      __end_ = __construct_to_copy(__old_end - __n, __old_end, __end_);
+      __copy_backward(__position.base(), __old_end - __n, __old_end);
+      __copy(__first, __last, __position.base());
+    }
+  }
+
+}; // class small_vector
+
+template <class _Tp, std::size_t _N, class _Allocator, class _GrowthPolicy>
+const typename small_vector<_Tp, _N, _Allocator, _GrowthPolicy>::size_type
+small_vector<_Tp, _N, _Allocator, _GrowthPolicy>::inline_capacity;
+
+// Non-member functions
+
+template <class _Tp, std::size_t _N, class _Allocator, class _GrowthPolicy>
+bool operator==(const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __x,
+                const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __y) {
+  return __x.size() == __y.size() && ft::equal(__x.begin(), __x.end(), __y.begin());
+}
+
+template <class _Tp, std::size_t _N, class _Allocator, class _GrowthPolicy>
+bool operator!=(const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __x,
+                const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __y) {
+  return !(__x == __y);
+}
+
+template <class _Tp, std::size_t _N, class _Allocator, class _GrowthPolicy>
+bool operator< (const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __x,
+                const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __y) {
+  return ft::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end());
+}
+
+template <class _Tp, std::size_t _N, class _Allocator, class _GrowthPolicy>
+bool operator> (const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __x,
+                const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __y) {
+  return __y < __x;
+}
+
+template <class _Tp, std::size_t _N, class _Allocator, class _GrowthPolicy>
+bool operator>=(const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __x,
+                const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __y) {
+  return !(__x < __y);
+}
+
+template <class _Tp, std::size_t _N, class _Allocator, class _GrowthPolicy>
+bool operator<=(const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __x,
+                const small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __y) {
+  return !(__y < __x);
+}
+
+template <class _Tp, std::size_t _N, class _Allocator, class _GrowthPolicy>
+void swap(small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __x,
+          small_vector<_Tp, _N, _Allocator, _GrowthPolicy>& __y) {
+  __x.swap(__y);
+}
+
+} // namespace ft
+
+#endif // SMALL_VECTOR_HPP
@@ -1,8 +1,13 @@
 #ifndef STACK_HPP
 #define STACK_HPP
 
+#include "__config.hpp"
 #include "vector.hpp"
 
+#if FT_CXX11
+#include <utility> // for move, forward
+#endif
+
 namespace ft {
 
 template <class _Tp, class _Container = ft::vector<_Tp> >
@@ -21,6 +26,19 @@ class stack {
 
   explicit stack(const container_type& __c) : c(__c) {}
 
+  stack(const stack& __q) : c(__q.c) {}
+
+#if FT_CXX11
+  explicit stack(container_type&& __c) : c(std::move(__c)) {}
+
+  stack(stack&& __q) : c(std::move(__q.c)) {}
+
+  stack& operator=(stack&& __q) {
+    c = std::move(__q.c);
+    return *this;
+  }
+#endif
+
   ~stack() {}
 
   stack& operator=(const stack& __q) {
@@ -40,6 +58,13 @@ class stack {
 
   void push(const value_type& __v) { c.push_back(__v); }
 
+#if FT_CXX11
+  void push(value_type&& __v) { c.push_back(std::move(__v)); }
+
+  template <class... _Args>
+  void emplace(_Args&&... __args) { c.emplace_back(std::forward<_Args>(__args)...); }
+#endif
+
   void pop() { c.pop_back(); }
 
   // operator== and operator< need to access to protected variable of stack.
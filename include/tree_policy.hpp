@@ -0,0 +1,135 @@
+#ifndef TREE_POLICY_HPP
+#define TREE_POLICY_HPP
+
+#include <limits> // for numeric_limits
+
+namespace ft {
+
+/*
+** Tree policies choose how the red-black tree under map and set links its
+** nodes and what it keeps in them. Each policy provides
+**
+**   static const bool threaded;
+**   static const bool counted;
+**   static const bool aggregated;
+**   typedef ... monoid;
+**
+** threaded tells whether missing children are replaced by threads to the
+** neighbouring nodes in key order (see __tree_node). counted tells whether
+** each node holds the size of its subtree (see tree_order_statistic).
+** aggregated tells whether each node holds the aggregate of its subtree under
+** monoid (see tree_aggregate), which is tree_no_monoid otherwise.
+*/
+
+struct tree_no_monoid {
+  typedef tree_no_monoid value_type;
+};
+
+// Missing children point at a nil node and nodes hold nothing more (default)
+
+struct tree_plain {
+  static const bool threaded = false;
+  static const bool counted = false;
+  static const bool aggregated = false;
+  typedef tree_no_monoid monoid;
+};
+
+/*
+** Missing children are threads, so ++ and -- follow a single link when there
+** is no subtree to go down
+**
+** Q: Why is it not the default?
+** A: Scans of maps that fit in the cache were about 30% faster, but past
+**    ~500k entries they were 15 to 25% slower: a thread jumps to an ancestor
+**    far away in memory, while climbing parent links mostly reads nodes that
+**    the way down has just loaded. Insertions and erasures also have threads
+**    to keep up to date.
+*/
+
+struct tree_threaded {
+  static const bool threaded = true;
+  static const bool counted = false;
+  static const bool aggregated = false;
+  typedef tree_no_monoid monoid;
+};
+
+/*
+** Adds to _Base the size of the subtree under each node, kept up to date by
+** insertions, erasures and rotations. map and set can then find the k-th key
+** (nth) and the number of keys before a key (rank), and ft::distance and
+** ft::advance work on their iterators, in O(log n) instead of O(n).
+** A node takes one more word.
+*/
+
+template <class _Base = tree_plain>
+struct tree_order_statistic : public _Base {
+  static const bool counted = true;
+};
+
+/*
+** Adds to _Base the aggregate under _Monoid of the subtree under each node,
+** so that map::aggregate and set::aggregate combine the values of a range of
+** keys in O(log n). The values are the mapped values of a map and the keys of
+** a set. A monoid provides
+**
+**   typedef ... value_type;
+**   static value_type identity();
+**   static value_type combine(const value_type& __x, const value_type& __y);
+**
+** where combine is associative and identity is neutral for it. It needs not be
+** commutative: values are always combined in key order. value_type must be
+** constructible from the mapped values or keys.
+**
+** Q: What if a mapped value changes in place?
+** A: Nodes cannot see writes through iterators or operator[], so the aggregates
+**    above it go stale until map::refresh is called on its iterator.
+**    insert_or_assign and upsert refresh by themselves.
+*/
+
+template <class _Monoid, class _Base = tree_plain>
+struct tree_aggregate : public _Base {
+  static const bool aggregated = true;
+  typedef _Monoid monoid;
+};
+
+// Monoids for tree_aggregate
+
+template <class _Tp>
+struct sum_monoid {
+  typedef _Tp value_type;
+
+  static value_type identity() { return value_type(); }
+
+  static value_type combine(const value_type& __x, const value_type& __y) { return __x + __y; }
+};
+
+template <class _Tp>
+struct min_monoid {
+  typedef _Tp value_type;
+
+  static value_type identity() { return std::numeric_limits<value_type>::max(); }
+
+  static value_type combine(const value_type& __x, const value_type& __y) {
+    return __y < __x ? __y : __x;
+  }
+};
+
+template <class _Tp>
+struct max_monoid {
+  typedef _Tp value_type;
+
+  // numeric_limits<_Tp>::lowest() is C++11
+
+  static value_type identity() {
+    return std::numeric_limits<value_type>::is_integer ? std::numeric_limits<value_type>::min()
+                                                       : -std::numeric_limits<value_type>::max();
+  }
+
+  static value_type combine(const value_type& __x, const value_type& __y) {
+    return __x < __y ? __y : __x;
+  }
+};
+
+} // namespace ft
+
+#endif // TREE_POLICY_HPP
@@ -1,6 +1,11 @@
 #ifndef TYPE_TRAITS_HPP
 #define TYPE_TRAITS_HPP
 
+#include <memory> // for allocator
+#include <string> // for basic_string
+
+#include "__config.hpp"
+
 namespace ft {
 
 // enable_if
@@ -42,6 +47,11 @@ struct remove_cv {
   typedef typename remove_volatile<typename remove_const<_Tp>::type>::type type;
 };
 
+// is_same
+
+template <class _Tp, class _Up> struct is_same : public false_type {};
+template <class _Tp>            struct is_same<_Tp, _Tp> : public true_type {};
+
 // is_integral
 
 template <class _Tp> struct __ft_is_integral : public false_type {};
@@ -60,6 +70,136 @@ template <>          struct __ft_is_integral<unsigned long> : public true_type {
 template <class _Tp>
 struct is_integral : public __ft_is_integral<typename remove_cv<_Tp>::type> {};
 
+// is_trivially_copyable / is_trivially_destructible /
+// is_trivially_default_constructible
+
+/*
+** Q: How can these be detected in C++98?
+** A: There is no way to do it in the language itself, but gcc and clang expose
+**    the compiler's knowledge through type trait builtins in every -std mode.
+**    Without them, only arithmetic and pointer types are treated as trivial.
+*/
+
+template <class _Tp> struct __ft_is_floating_point : public false_type {};
+template <>          struct __ft_is_floating_point<float> : public true_type {};
+template <>          struct __ft_is_floating_point<double> : public true_type {};
+template <>          struct __ft_is_floating_point<long double> : public true_type {};
+
+template <class _Tp> struct __ft_is_pointer : public false_type {};
+template <class _Tp> struct __ft_is_pointer<_Tp*> : public true_type {};
+
+template <class _Tp>
+struct __ft_is_scalar
+  : public integral_constant<bool,
+      __ft_is_integral<typename remove_cv<_Tp>::type>::value
+      || __ft_is_floating_point<typename remove_cv<_Tp>::type>::value
+      || __ft_is_pointer<typename remove_cv<_Tp>::type>::value> {};
+
+#if defined(__clang__)
+template <class _Tp>
+struct is_trivially_copyable
+  : public integral_constant<bool, __is_trivially_copyable(_Tp)> {};
+
+template <class _Tp>
+struct is_trivially_destructible
+  : public integral_constant<bool, __is_trivially_destructible(_Tp)> {};
+
+template <class _Tp>
+struct is_trivially_default_constructible
+  : public integral_constant<bool, __is_trivially_constructible(_Tp)> {};
+#elif defined(__GNUC__)
+template <class _Tp>
+struct is_trivially_copyable
+  : public integral_constant<bool, __is_trivially_copyable(_Tp)> {};
+
+template <class _Tp>
+struct is_trivially_destructible
+  : public integral_constant<bool, __has_trivial_destructor(_Tp)> {};
+
+template <class _Tp>
+struct is_trivially_default_constructible
+  : public integral_constant<bool, __is_trivially_constructible(_Tp)> {};
+#else
+template <class _Tp>
+struct is_trivially_copyable : public __ft_is_scalar<_Tp> {};
+
+template <class _Tp>
+struct is_trivially_destructible : public __ft_is_scalar<_Tp> {};
+
+template <class _Tp>
+struct is_trivially_default_constructible : public __ft_is_scalar<_Tp> {};
+#endif
+
+// is_bitwise_copyable
+
+/*
+** Opt-in for user types whose copies can be made with memcpy even though the
+** compiler cannot prove it (e.g. a user-declared copy constructor that only
+** copies its members). Specialize it as true_type in namespace ft.
+*/
+
+template <class _Tp>
+struct is_bitwise_copyable : public is_trivially_copyable<_Tp> {};
+
+// is_swap_relocatable
+
+/*
+** Opt-in for types that can be moved to another address by default-constructing
+** the destination and swapping it with the source. The default constructor must
+** be cheap and there must be a member swap that does not throw.
+** Specialize it as true_type in namespace ft.
+*/
+
+template <class _Tp>
+struct is_swap_relocatable : public false_type {};
+
+template <class _CharT, class _Traits, class _Allocator>
+struct is_swap_relocatable<std::basic_string<_CharT, _Traits, _Allocator> >
+  : public true_type {};
+
+// __has_trivial_construct
+
+/*
+** Containers may bypass allocator_type::construct and destroy only when the
+** allocator does nothing more than placement new and an explicit destructor
+** call, which is what std::allocator does
+*/
+
+template <class _Allocator>
+struct __has_trivial_construct : public false_type {};
+
+template <class _Tp>
+struct __has_trivial_construct<std::allocator<_Tp> > : public true_type {};
+
+// __is_transparent
+
+/*
+** True when _Compare declares a member type is_transparent, as std::less<>
+** does, which promises that it compares keys with other types directly.
+** _Up is the type looked up, only there to make the test depend on the
+** template parameter of the lookup.
+*/
+
+template <class _Compare>
+struct __has_is_transparent {
+ private:
+  typedef char __yes;
+  struct __no { char __c[2]; };
+
+  template <class _Cp>
+  static __yes __test(typename _Cp::is_transparent*);
+
+  template <class _Cp>
+  static __no __test(...);
+
+ public:
+  static const bool value = sizeof(__test<_Compare>(0)) == sizeof(__yes);
+};
+
+template <class _Compare, class _Up>
+struct __is_transparent
+  : public integral_constant<bool, __has_is_transparent<_Compare>::value> {};
+
 // type detectors
 
 template <class _Tp>
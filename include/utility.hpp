@@ -1,6 +1,12 @@
 #ifndef UTILITY_HPP
 #define UTILITY_HPP
 
+#include "__config.hpp"
+
+#if FT_CXX11
+#include <utility> // for forward
+#endif
+
 namespace ft {
 
 template <class T1, class T2>
@@ -16,6 +22,15 @@ struct pair {
   template <class U1, class U2>
   pair(const pair<U1, U2>& x) : first(x.first), second(x.second) {}
 
+#if FT_CXX11
+  template <class U1, class U2>
+  pair(U1&& v1, U2&& v2) : first(std::forward<U1>(v1)), second(std::forward<U2>(v2)) {}
+
+  template <class U1, class U2>
+  pair(pair<U1, U2>&& x)
+    : first(std::forward<U1>(x.first)), second(std::forward<U2>(x.second)) {}
+#endif
+
   T1 first;
   T2 second;
 };
@@ -50,6 +65,16 @@ bool operator>=(const pair<T1, T2>& x, const pair<T1, T2>& y) {
   return !(x < y);
 }
 
+/*
+** Tag for the map and set members taking a range whose keys are already
+** strictly increasing, as std::sorted_unique does for C++23 flat_map.
+** The order is trusted, not checked.
+*/
+
+struct sorted_unique_t {};
+
+const sorted_unique_t sorted_unique = sorted_unique_t();
+
 template <class T1, class T2>
 pair<T1, T2> make_pair(const T1& v1, const T2& v2) {
   return pair<T1, T2>(v1, v2);
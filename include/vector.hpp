@@ -1,26 +1,38 @@
 #ifndef VECTOR_HPP
 #define VECTOR_HPP
 
-#include <memory> // for allaocator, allocator_traits
+#include <memory> // for allaocator, allocator_traits, uninitialized_fill_n
 #include <iterator> // for reverse_iterator
 #include <algorithm> // for copy, min
 #include <stdexcept> // for out_of_range and length_error
 #include <limits> // for numeric_limits
+#include <cstring> // for memcpy, memmove
+
+#include "__config.hpp"
+
+#if FT_CXX11
+#include <utility> // for move, forward
+#include <type_traits> // for is_nothrow_move_constructible
+#endif
 
 #include "iterator.hpp"
 #include "vector_iterator.hpp"
 #include "iterator_traits.hpp"
 #include "type_traits.hpp"
 #include "algorithm.hpp"
+#include "growth_policy.hpp"
+#include "mmap_allocator.hpp"
 
 namespace ft {
 
-template <class _Tp, class _Allocator = std::allocator<_Tp> >
+template <class _Tp, class _Allocator = std::allocator<_Tp>,
+          class _GrowthPolicy = ft::growth_doubling>
 class vector {
 
  public:
   typedef _Tp                                           value_type;
   typedef _Allocator                                    allocator_type;
+  typedef _GrowthPolicy                                 growth_policy;
   typedef typename allocator_type::reference            reference;
   typedef typename allocator_type::const_reference      const_reference;
   typedef typename allocator_type::pointer              pointer;
@@ -38,6 +50,48 @@ class vector {
   pointer __end_cap_;
   allocator_type __alloc_;
 
+  // Elements can be copied with memcpy/memmove and left undestroyed only when
+  // the allocator does not customize construct and destroy
+
+  typedef ft::integral_constant<bool,
+      ft::is_bitwise_copyable<value_type>::value
+      && ft::__has_trivial_construct<allocator_type>::value>  __bitwise_copy_tag;
+  typedef ft::integral_constant<bool,
+      ft::is_trivially_destructible<value_type>::value
+      && ft::__has_trivial_construct<allocator_type>::value>  __trivial_destroy_tag;
+  typedef ft::integral_constant<bool,
+      ft::is_trivially_default_constructible<value_type>::value
+      && ft::__has_trivial_construct<allocator_type>::value>  __default_init_tag;
+
+  typedef ft::integral_constant<bool,
+      __bitwise_copy_tag::value
+      && ft::has_reallocate<allocator_type>::value>           __reallocate_tag;
+  typedef ft::integral_constant<bool,
+      __bitwise_copy_tag::value
+      && ft::has_allocate_zeroed<allocator_type>::value>      __zeroed_alloc_tag;
+
+  // Bitwise copyable elements are already relocated with memcpy, and since
+  // C++11 elements that can be moved without throwing are moved instead
+
+#if FT_CXX11
+  typedef ft::integral_constant<bool,
+      !__bitwise_copy_tag::value
+      && std::is_nothrow_move_constructible<value_type>::value> __move_relocate_tag;
+#else
+  typedef ft::false_type                                      __move_relocate_tag;
+#endif
+
+  typedef ft::integral_constant<bool,
+      ft::is_swap_relocatable<value_type>::value
+      && !__bitwise_copy_tag::value
+      && !__move_relocate_tag::value>                        __swap_relocate_tag;
+
+  template <class _Iterator>
+  struct __bitwise_range_tag
+    : public ft::integral_constant<bool,
+        __bitwise_copy_tag::value
+        && ft::__is_contiguous_iterator<_Iterator, value_type>::value> {};
+
  public:
 
   // Default constructor
@@ -50,8 +104,8 @@ class vector {
 
   vector(size_type __n, const_reference __x = value_type(),
          const allocator_type& __a = allocator_type())
-    : __alloc_(__a) {
-    if (0 < __n) {
+    : __begin_(NULL), __end_(NULL), __end_cap_(NULL), __alloc_(__a) {
+    if (0 < __n && !__append_zeroed(__n, __n, __x)) {
       __allocate(__n);
       __end_ = __construct_to_fill(__begin_, __n, __x);
     }
@@ -69,7 +123,8 @@ class vector {
 
   // Copy constructor
 
-  vector(const vector& __x) : __alloc_(__x.__alloc_) {
+  vector(const vector& __x)
+    : __begin_(NULL), __end_(NULL), __end_cap_(NULL), __alloc_(__x.__alloc_) {
     size_type __n = __x.size();
     if (0 < __n) {
       __allocate(__n);
@@ -77,6 +132,16 @@ class vector {
     }
   }
 
+#if FT_CXX11
+  // Move constructor
+
+  vector(vector&& __x) noexcept
+    : __begin_(__x.__begin_), __end_(__x.__end_), __end_cap_(__x.__end_cap_),
+      __alloc_(std::move(__x.__alloc_)) {
+    __x.__begin_ = __x.__end_ = __x.__end_cap_ = NULL;
+  }
+#endif
+
   // Destructor
 
   ~vector() {
@@ -94,12 +159,12 @@ class vector {
         clear();
         __deallocate();
       } else if (__x.size() <= size()) {
-        pointer __new_end = std::copy(__x.begin(), __x.end(), __begin_);
+        pointer __new_end = __copy(__x.begin(), __x.end(), __begin_);
         __destroy(__new_end, __end_);
         __end_ = __begin_ + __x.size();
       } else if (__x.size() <= capacity()) {
         const_iterator __s = __x.begin() + size();
-        std::copy(__x.begin(), __s, __begin_);
+        __copy(__x.begin(), __s, __begin_);
         __end_ = __construct_to_copy(__s, __x.end(), __end_);
       } else {
         clear();
@@ -111,6 +176,16 @@ class vector {
     return *this;
   }
 
+#if FT_CXX11
+  vector& operator=(vector&& __x) noexcept {
+    if (this != &__x) {
+      __deallocate();
+      swap(__x);
+    }
+    return *this;
+  }
+#endif
+
   // Iterators
 
   iterator begin() {
@@ -159,12 +234,42 @@ class vector {
   void resize(size_type __sz, value_type __val = value_type()) {
     size_type __cs = size();
     if (__cs < __sz) {
-      insert(end(), __sz - __cs, __val);
+      if (!__append_zeroed(__sz - __cs, __recommend(__sz), __val)) {
+        insert(end(), __sz - __cs, __val);
+      }
     } else if (__sz < __cs) {
       erase(begin() + __sz, end());
     }
   }
 
+  /*
+  ** Extensions for buffers that are about to be overwritten, e.g. by read()
+  ** New elements of trivial types are left uninitialized, so the memory is
+  ** only written once. Other types are value-initialized as with resize()
+  */
+
+  void resize_default_init(size_type __sz) {
+    size_type __cs = size();
+    if (__cs < __sz) {
+      append_uninitialized(__sz - __cs);
+    } else if (__sz < __cs) {
+      erase(begin() + __sz, end());
+    }
+  }
+
+  // Returns an iterator to the first appended element
+
+  iterator append_uninitialized(size_type __n) {
+    size_type __s = size();
+    if (max_size() - __s < __n) {
+      __throw_length_error();
+    } else if (capacity() < __s + __n) {
+      __reallocate(__recommend(__s + __n), __reallocate_tag());
+    }
+    __end_ = __construct_to_default(__end_, __n, __default_init_tag());
+    return begin() + __s;
+  }
+
   size_type capacity() const {
     return static_cast<size_type>(__end_cap_ - __begin_);
   }
@@ -177,20 +282,7 @@ class vector {
     if (max_size() < __n) {
       __throw_length_error();
     } else if (capacity() < __n) {
-      pointer __new_begin = __alloc_.allocate(__n);
-      try {
-        __construct_to_copy(begin(), end(), __new_begin);
-      } catch (...) {
-        __alloc_.deallocate(__new_begin, __n);
-        throw;
-      }
-      if (__begin_ != NULL) {
-        __destroy(__begin_, __end_);
-        __alloc_.deallocate(__begin_, capacity());
-      }
-      __end_cap_ = __new_begin + __n;
-      __end_ = __new_begin + size();
-      __begin_ = __new_begin;
+      __reallocate(__n, __reallocate_tag());
     }
   }
 
@@ -253,6 +345,51 @@ class vector {
 
   void pop_back() { erase(end() - 1); }
 
+#if FT_CXX11
+  void push_back(value_type&& __val) { emplace_back(std::move(__val)); }
+
+  template <class... _Args>
+  void emplace_back(_Args&&... __args) {
+    size_type __s = size();
+    if (__end_ != __end_cap_) {
+      __construct(__end_, std::forward<_Args>(__args)...);
+      ++__end_;
+    } else if (max_size() == __s) {
+      __throw_length_error();
+    } else if (__reallocate_tag::value) {
+      // __args may refer to an element of this vector
+      value_type __v(std::forward<_Args>(__args)...);
+      __reallocate(__recommend(__s + 1), __reallocate_tag());
+      __construct(__end_, std::move(__v));
+      ++__end_;
+    } else {
+      size_type __cap = __recommend(__s + 1);
+      pointer __new_begin = __alloc_.allocate(__cap);
+      try {
+        __construct(__new_begin + __s, std::forward<_Args>(__args)...);
+      } catch (...) {
+        __alloc_.deallocate(__new_begin, __cap);
+        throw;
+      }
+      __relocate_to(__new_begin, __cap, __end_, 1);
+    }
+  }
+
+  // The new element is appended, then rotated into place
+
+  template <class... _Args>
+  iterator emplace(iterator __position, _Args&&... __args) {
+    difference_type __off = __position - begin();
+    emplace_back(std::forward<_Args>(__args)...);
+    std::rotate(begin() + __off, end() - 1, end());
+    return begin() + __off;
+  }
+
+  iterator insert(iterator __position, value_type&& __val) {
+    return emplace(__position, std::move(__val));
+  }
+#endif
+
   iterator insert(iterator __position, const value_type& __val) {
     size_type __off = size() == 0 ? 0 : __position - begin();
     insert(__position, static_cast<size_type>(1), __val);
@@ -267,44 +404,45 @@ class vector {
       ;
     } else if (__ms - __s < __n) {
       __throw_length_error();
+    } else if (__cap < __s + __n && __reallocate_tag::value) {
+      // __x may refer to an element of this vector
+      difference_type __off = __position - begin();
+      value_type __v = __x;
+      __reallocate(__recommend(__s + __n), __reallocate_tag());
+      insert(begin() + __off, __n, __v);
     } else if (__cap < __s + __n) {
-      __cap = __ms - __cap < __cap ? 0 : __cap + __cap;
-      if (__cap < __s + __n) {
-        __cap = __s + __n;
-      }
+      __cap = __recommend(__s + __n);
       pointer __new_begin = __alloc_.allocate(__cap);
-      pointer __tmp;
+      pointer __new_pos = __new_begin + (__position - begin());
       try {
-        __tmp = __construct_to_copy(begin(), __position, __new_begin);
-        __tmp = __construct_to_fill(__tmp, __n, __x);
-        __construct_to_copy(__position, end(), __tmp);
+        __construct_to_fill(__new_pos, __n, __x);
       } catch (...) {
-        __destroy(__new_begin, __tmp);
         __alloc_.deallocate(__new_begin, __cap);
         throw;
       }
-      if (__begin_ != NULL) {
-        __destroy(__begin_, __end_);
-        __alloc_.deallocate(__begin_, capacity());
+      __relocate_to(__new_begin, __cap, __position.base(), __n);
+    } else {
+      // If __x is an element at or after __position, it is shifted by __n
+      const_pointer __xr = &__x;
+      if (__position.base() <= __xr && __xr < __end_) {
+        __xr += __n;
       }
-      __end_cap_ = __new_begin + __cap;
-      __end_ = __new_begin + __s + __n;
-      __begin_ = __new_begin;
-    } else if (static_cast<size_type>(end() - __position) < __n) {
-      __construct_to_copy(__position, end(), &(*__position) + __n);
-      try {
-        __construct_to_fill(__end_, __n - static_cast<size_type>(end() - __position), __x);
-      } catch (...) {
-        __destroy(&(*__position) + __n, __end_ + __n);
-        throw;
+      if (static_cast<size_type>(end() - __position) < __n) {
+        __construct_to_copy(__position, end(), &(*__position) + __n);
+        try {
+          __construct_to_fill(__end_, __n - static_cast<size_type>(end() - __position), *__xr);
+        } catch (...) {
+          __destroy(&(*__position) + __n, __end_ + __n);
+          throw;
+        }
+        __end_ += __n;
+        std::fill(__position, end() - __n, *__xr);
+      } else {
+        iterator __old_end = end();
+        __end_ = __construct_to_copy(__old_end - __n, __old_end, __end_);
+        __copy_backward(__position, __old_end - __n, __old_end);
+        std::fill(__position, __position + __n, *__xr);
       }
-      __end_ += __n;
-      std::fill(__position, end() - __n, __x);
-    } else {
-      iterator __old_end = end();
-      __end_ = __construct_to_copy(__old_end - __n, __old_end, __end_);
-      __copy_backward(__position, __old_end - __n, __old_end);
-      std::fill(__position, __position + __n, __x);
     }
   }
 
@@ -319,7 +457,7 @@ class vector {
   }
 
   iterator erase(iterator __position) {
-    std::copy(__position + 1, end(), __position);
+    __copy(__position + 1, end(), __position.base());
     __destroy(__end_ - 1, __end_);
     --__end_;
     return __position;
@@ -327,9 +465,9 @@ class vector {
 
   iterator erase(iterator __first, iterator __last) {
     if (__first != __last) {
-      iterator __new_end = std::copy(__last, end(), __first);
-      __destroy(__new_end.base(), __end_);
-      __end_ = __new_end.base();
+      pointer __new_end = __copy(__last, end(), __first.base());
+      __destroy(__new_end, __end_);
+      __end_ = __new_end;
     }
     return __first;
   }
@@ -363,6 +501,48 @@ class vector {
     __end_cap_ = __begin_ + __n;
   }
 
+  /*
+  ** Appends __n copies of __x by moving to a zeroed buffer of __cap when __x
+  ** is all zero bytes and the allocator can provide one, so value-initialized
+  ** elements cost nothing until their pages are touched
+  ** Returns false, doing nothing, when this does not apply. The current
+  ** buffer may hold stale bytes, so it is only used when it must grow anyway
+  */
+
+  bool __append_zeroed(size_type __n, size_type __cap, const_reference __x) {
+    return __append_zeroed(__n, __cap, __x, __zeroed_alloc_tag());
+  }
+
+  bool __append_zeroed(size_type, size_type, const_reference, ft::false_type) {
+    return false;
+  }
+
+  bool __append_zeroed(size_type __n, size_type __cap, const_reference __x, ft::true_type) {
+    size_type __s = size();
+    if (max_size() - __s < __n || __s + __n <= capacity() || !__is_zero_bits(__x)) {
+      return false;
+    }
+    pointer __new_begin = __alloc_.allocate_zeroed(__cap);
+    __bitwise_copy(__begin_, __end_, __new_begin);
+    if (__begin_ != NULL) {
+      __alloc_.deallocate(__begin_, capacity());
+    }
+    __begin_ = __new_begin;
+    __end_ = __new_begin + __s + __n;
+    __end_cap_ = __new_begin + __cap;
+    return true;
+  }
+
+  static bool __is_zero_bits(const_reference __x) {
+    const unsigned char* __p = reinterpret_cast<const unsigned char*>(&__x);
+    for (size_type __i = 0; __i < sizeof(value_type); ++__i) {
+      if (__p[__i] != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   void __deallocate() {
     if (__begin_ != NULL) {
       clear();
@@ -372,12 +552,32 @@ class vector {
   }
 
   void __destroy(pointer __begin, pointer __end) {
+    __destroy(__begin, __end, __trivial_destroy_tag());
+  }
+
+  void __destroy(pointer, pointer, ft::true_type) {}
+
+  void __destroy(pointer __begin, pointer __end, ft::false_type) {
     for (; __begin != __end; ++__begin) {
       __alloc_.destroy(__begin);
     }
   }
 
   pointer __construct_to_fill(pointer __end, size_type __n, const_reference __x) {
+    return __construct_to_fill(__end, __n, __x, __bitwise_copy_tag());
+  }
+
+  // Bitwise copyable types are copy constructed in place without the
+  // allocator, which the compiler turns into memset or vector stores
+
+  pointer __construct_to_fill(pointer __end, size_type __n, const_reference __x,
+                              ft::true_type) {
+    std::uninitialized_fill_n(__end, __n, __x);
+    return __end + __n;
+  }
+
+  pointer __construct_to_fill(pointer __end, size_type __n, const_reference __x,
+                              ft::false_type) {
     pointer __old_end = __end;
     try {
       for (; 0 < __n; --__n, ++__end) {
@@ -390,8 +590,37 @@ class vector {
     return __end;
   }
 
+  pointer __construct_to_default(pointer __end, size_type __n, ft::true_type) {
+    return __end + __n;
+  }
+
+  pointer __construct_to_default(pointer __end, size_type __n, ft::false_type) {
+    return __construct_to_fill(__end, __n, value_type());
+  }
+
+#if FT_CXX11
+  template <class... _Args>
+  void __construct(pointer __p, _Args&&... __args) {
+    std::allocator_traits<allocator_type>::construct(__alloc_, __p,
+                                                     std::forward<_Args>(__args)...);
+  }
+#endif
+
   template <class _ForwardIterator>
   pointer __construct_to_copy(_ForwardIterator __first, _ForwardIterator __last, pointer __end) {
+    return __construct_to_copy(__first, __last, __end,
+                               __bitwise_range_tag<_ForwardIterator>());
+  }
+
+  template <class _ForwardIterator>
+  pointer __construct_to_copy(_ForwardIterator __first, _ForwardIterator __last, pointer __end,
+                              ft::true_type) {
+    return __bitwise_copy(__first, __last, __end);
+  }
+
+  template <class _ForwardIterator>
+  pointer __construct_to_copy(_ForwardIterator __first, _ForwardIterator __last, pointer __end,
+                              ft::false_type) {
     pointer __old_end = __end;
     try {
       for (; __first != __last; ++__end, ++__first) {
@@ -404,6 +633,126 @@ class vector {
     return __end;
   }
 
+  // Moves the elements to a buffer of __n
+  // If the allocator can resize its blocks and the elements are bitwise
+  // copyable, the buffer is grown without copying whenever possible
+
+  void __reallocate(size_type __n, ft::true_type) {
+    size_type __s = size();
+    __begin_ = __alloc_.reallocate(__begin_, capacity(), __n);
+    __end_ = __begin_ + __s;
+    __end_cap_ = __begin_ + __n;
+  }
+
+  void __reallocate(size_type __n, ft::false_type) {
+    __relocate_to(__alloc_.allocate(__n), __n, __end_, 0);
+  }
+
+  /*
+  ** Moves the elements into __new_begin, a buffer of __cap in which __n
+  ** elements have already been constructed where __position will land, then
+  ** adopts it
+  ** If anything throws, the vector is left unchanged and the buffer and its
+  ** new elements are released
+  */
+
+  void __relocate_to(pointer __new_begin, size_type __cap, pointer __position, size_type __n) {
+    pointer __new_pos = __new_begin + (__position - __begin_);
+    try {
+      __relocate(__begin_, __position, __new_begin);
+      try {
+        __relocate(__position, __end_, __new_pos + __n);
+      } catch (...) {
+        __unrelocate(__new_begin, __new_pos, __begin_);
+        throw;
+      }
+    } catch (...) {
+      __destroy(__new_pos, __new_pos + __n);
+      __alloc_.deallocate(__new_begin, __cap);
+      throw;
+    }
+    size_type __s = size() + __n;
+    if (__begin_ != NULL) {
+      __destroy(__begin_, __end_);
+      __alloc_.deallocate(__begin_, capacity());
+    }
+    __end_cap_ = __new_begin + __cap;
+    __end_ = __new_begin + __s;
+    __begin_ = __new_begin;
+  }
+
+  /*
+  ** Constructs [__first, __last) into raw storage at __result
+  **
+  ** Q: How can this be cheaper than a copy in C++98?
+  ** A: For swap relocatable types, each element is default-constructed in
+  **    place and swapped with its source, which only exchanges the handles of
+  **    nested containers and leaves an empty object behind
+  */
+
+  pointer __relocate(pointer __first, pointer __last, pointer __result) {
+    return __relocate(__first, __last, __result, __swap_relocate_tag());
+  }
+
+  pointer __relocate(pointer __first, pointer __last, pointer __result, ft::false_type) {
+#if FT_CXX11
+    if (__move_relocate_tag::value) {
+      return __construct_to_copy(std::make_move_iterator(__first),
+                                 std::make_move_iterator(__last), __result);
+    }
+#endif
+    return __construct_to_copy(__first, __last, __result);
+  }
+
+  pointer __relocate(pointer __first, pointer __last, pointer __result, ft::true_type) {
+    pointer __old_first = __first;
+    pointer __old_result = __result;
+    try {
+      for (; __first != __last; ++__first, ++__result) {
+        __alloc_.construct(__result, value_type());
+        __result->swap(*__first);
+      }
+    } catch (...) {
+      __unrelocate(__old_result, __result, __old_first);
+      throw;
+    }
+    return __result;
+  }
+
+  // Undoes __relocate of the elements now in [__first, __last) back to __result
+
+  void __unrelocate(pointer __first, pointer __last, pointer __result) {
+    __unrelocate(__first, __last, __result, __swap_relocate_tag());
+  }
+
+  void __unrelocate(pointer __first, pointer __last, pointer __result, ft::false_type) {
+#if FT_CXX11
+    if (__move_relocate_tag::value) {
+      for (pointer __p = __first; __p != __last; ++__p, ++__result) {
+        __alloc_.destroy(__result);
+        __construct(__result, std::move(*__p));
+      }
+    }
+#endif
+    (void)__result;
+    __destroy(__first, __last);
+  }
+
+  void __unrelocate(pointer __first, pointer __last, pointer __result, ft::true_type) {
+    for (pointer __p = __first; __p != __last; ++__p, ++__result) {
+      __p->swap(*__result);
+    }
+    __destroy(__first, __last);
+  }
+
+  // Capacity to allocate when __new_size elements do not fit anymore
+
+  size_type __recommend(size_type __new_size) const {
+    size_type __cap = growth_policy::recommend(capacity(), __new_size, max_size(),
+                                               sizeof(value_type));
+    return __cap < __new_size ? __new_size : __cap;
+  }
+
   void __throw_length_error() const {
     throw std::length_error("vector");
   }
@@ -412,12 +761,23 @@ class vector {
     throw std::out_of_range("vector");
   }
 
+  // The length of an input range is unknown before reading it, so its elements
+  // are appended, with amortized reallocations, then rotated into place
+
   template <class _Iterator>
   void __insert_range(iterator __position, _Iterator __first, _Iterator __last,
                       std::input_iterator_tag) {
-    for (; __first != __last; ++__first, ++__position) {
-      __position = insert(__position, *__first);
+    difference_type __off = __position - begin();
+    size_type __old_size = size();
+    try {
+      for (; __first != __last; ++__first) {
+        push_back(*__first);
+      }
+    } catch (...) {
+      erase(begin() + __old_size, end());
+      throw;
     }
+    std::rotate(begin() + __off, begin() + __old_size, end());
   }
 
   template <class _Iterator>
@@ -431,29 +791,21 @@ class vector {
       ;
     } else if (__ms - __s < static_cast<size_type>(__n)) {
       __throw_length_error();
+    } else if (__cap < __s + __n && __reallocate_tag::value) {
+      difference_type __off = __position - begin();
+      __reallocate(__recommend(__s + __n), __reallocate_tag());
+      __insert_range(begin() + __off, __first, __last, std::forward_iterator_tag());
     } else if (__cap < __s + __n) {
-      __cap = __ms - __cap < __cap ? 0 : __cap + __cap;
-      if (__cap < __s + __n) {
-        __cap = __s + __n;
-      }
+      __cap = __recommend(__s + __n);
       pointer __new_begin = __alloc_.allocate(__cap);
-      pointer __tmp;
+      pointer __new_pos = __new_begin + (__position - begin());
       try {
-        __tmp = __construct_to_copy(begin(), __position, __new_begin);
-        __tmp = __construct_to_copy(__first, __last, __tmp);
-        __construct_to_copy(__position, end(), __tmp);
+        __construct_to_copy(__first, __last, __new_pos);
       } catch (...) {
-        __destroy(__new_begin, __tmp);
         __alloc_.deallocate(__new_begin, __cap);
         throw;
       }
-      if (__begin_ != NULL) {
-        __destroy(__begin_, __end_);
-        __alloc_.deallocate(__begin_, capacity());
-      }
-      __end_cap_ = __new_begin + __cap;
-      __end_ = __new_begin + __s + __n;
-      __begin_ = __new_begin;
+      __relocate_to(__new_begin, __cap, __position.base(), __n);
     } else if (end() - __position < __n) {
       __construct_to_copy(__position, end(), &(*__position) + __n);
       _Iterator __middle = __first;
@@ -465,61 +817,113 @@ class vector {
         throw;
       }
       __end_ += __n;
-      std::copy(__first, __middle, __position);
+      __copy(__first, __middle, __position.base());
     } else if (0 < __n) {
       iterator __old_end = end();
       __end_ = __construct_to_copy(__old_end - __n, __old_end, __end_);
       __copy_backward(__position, __old_end - __n, __old_end);
-      std::copy(__first, __last, __position);
+      __copy(__first, __last, __position.base());
     }
   }
 
+  // Assigns [__first, __last) over live elements starting at __result
+  // The ranges may overlap as long as __result does not go past __first
+
+  template <class _Iterator>
+  pointer __copy(_Iterator __first, _Iterator __last, pointer __result) {
+    return __copy(__first, __last, __result, __bitwise_range_tag<_Iterator>());
+  }
+
+  template <class _Iterator>
+  pointer __copy(_Iterator __first, _Iterator __last, pointer __result, ft::true_type) {
+    return __bitwise_copy(__first, __last, __result);
+  }
+
+  template <class _Iterator>
+  pointer __copy(_Iterator __first, _Iterator __last, pointer __result, ft::false_type) {
+    return std::copy(__first, __last, __result);
+  }
+
   void __copy_backward(iterator __first, iterator __last, iterator __result) {
+    __copy_backward(__first, __last, __result, __bitwise_copy_tag());
+  }
+
+  void __copy_backward(iterator __first, iterator __last, iterator __result, ft::true_type) {
+    __bitwise_copy(__first, __last, __result.base() - (__last - __first));
+  }
+
+  void __copy_backward(iterator __first, iterator __last, iterator __result, ft::false_type) {
     while (__last != __first) {
       *(--__result) = *(--__last);
     }
   }
 
+  // memmove rather than memcpy as erase and insert shift elements within
+  // the same buffer
+  // Q: Why cast to void*?
+  // A: The opt-in is_bitwise_copyable may select non-trivial class types and
+  //    gcc's -Wclass-memaccess would otherwise reject them
+
+  template <class _Iterator>
+  pointer __bitwise_copy(_Iterator __first, _Iterator __last, pointer __result) {
+    size_type __n = static_cast<size_type>(__last - __first);
+    if (__n != 0) {
+      std::memmove(static_cast<void*>(__result), static_cast<const void*>(&*__first),
+                   __n * sizeof(value_type));
+    }
+    return __result + __n;
+  }
+
 }; // class vector
 
 // Non-member functions
 
-template <class _Tp, class _Allocator>
-bool operator==(const vector<_Tp, _Allocator>& __x, const vector<_Tp, _Allocator>& __y) {
-  const typename vector<_Tp, _Allocator>::size_type __sz = __x.size();
+template <class _Tp, class _Allocator, class _GrowthPolicy>
+bool operator==(const vector<_Tp, _Allocator, _GrowthPolicy>& __x,
+                const vector<_Tp, _Allocator, _GrowthPolicy>& __y) {
+  const typename vector<_Tp, _Allocator, _GrowthPolicy>::size_type __sz = __x.size();
   return __sz == __y.size() && ft::equal(__x.begin(), __x.end(), __y.begin());
 }
 
-template <class _Tp, class _Allocator>
-bool operator!=(const vector<_Tp, _Allocator>& __x, const vector<_Tp, _Allocator>& __y) {
+template <class _Tp, class _Allocator, class _GrowthPolicy>
+bool operator!=(const vector<_Tp, _Allocator, _GrowthPolicy>& __x,
+                const vector<_Tp, _Allocator, _GrowthPolicy>& __y) {
   return !(__x == __y);
 }
 
-template <class _Tp, class _Allocator>
-bool operator< (const vector<_Tp, _Allocator>& __x, const vector<_Tp, _Allocator>& __y) {
+template <class _Tp, class _Allocator, class _GrowthPolicy>
+bool operator< (const vector<_Tp, _Allocator, _GrowthPolicy>& __x,
+                const vector<_Tp, _Allocator, _GrowthPolicy>& __y) {
   return ft::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end());
 }
 
-template <class _Tp, class _Allocator>
-bool operator> (const vector<_Tp, _Allocator>& __x, const vector<_Tp, _Allocator>& __y) {
+template <class _Tp, class _Allocator, class _GrowthPolicy>
+bool operator> (const vector<_Tp, _Allocator, _GrowthPolicy>& __x,
+                const vector<_Tp, _Allocator, _GrowthPolicy>& __y) {
   return __y < __x;
 }
 
-template <class _Tp, class _Allocator>
-bool operator>=(const vector<_Tp, _Allocator>& __x, const vector<_Tp, _Allocator>& __y) {
+template <class _Tp, class _Allocator, class _GrowthPolicy>
+bool operator>=(const vector<_Tp, _Allocator, _GrowthPolicy>& __x,
+                const vector<_Tp, _Allocator, _GrowthPolicy>& __y) {
   return !(__x < __y);
 }
 
-template <class _Tp, class _Allocator>
-bool operator<=(const vector<_Tp, _Allocator>& __x, const vector<_Tp, _Allocator>& __y) {
+template <class _Tp, class _Allocator, class _GrowthPolicy>
+bool operator<=(const vector<_Tp, _Allocator, _GrowthPolicy>& __x,
+                const vector<_Tp, _Allocator, _GrowthPolicy>& __y) {
   return !(__y < __x);
 }
 
-template <class _Tp, class _Allocator>
-void swap(vector<_Tp, _Allocator>& __x, vector<_Tp, _Allocator>& __y) {
+template <class _Tp, class _Allocator, class _GrowthPolicy>
+void swap(vector<_Tp, _Allocator, _GrowthPolicy>& __x,
+          vector<_Tp, _Allocator, _GrowthPolicy>& __y) {
   __x.swap(__y);
 }
 
+template <class _Tp, class _Allocator, class _GrowthPolicy>
+struct is_swap_relocatable<vector<_Tp, _Allocator, _GrowthPolicy> > : public true_type {};
+
 }
 
 #endif
@@ -3,6 +3,7 @@
 
 #include <iterator>
 #include "iterator_traits.hpp"
+#include "type_traits.hpp"
 
 namespace ft {
 
@@ -155,6 +156,28 @@ operator+(typename vector_iterator<_Iter>::difference_type __n,
   return __x;
 }
 
+// __is_contiguous_iterator
+
+/*
+** True if _Iter walks over an array of _Tp, which lets vector replace
+** element-by-element copies with memcpy/memmove
+*/
+
+template <class _Iter, class _Tp>
+struct __is_contiguous_iterator : public ft::false_type {};
+
+template <class _Tp>
+struct __is_contiguous_iterator<_Tp*, _Tp> : public ft::true_type {};
+
+template <class _Tp>
+struct __is_contiguous_iterator<const _Tp*, _Tp> : public ft::true_type {};
+
+template <class _Tp>
+struct __is_contiguous_iterator<vector_iterator<_Tp*>, _Tp> : public ft::true_type {};
+
+template <class _Tp>
+struct __is_contiguous_iterator<vector_iterator<const _Tp*>, _Tp> : public ft::true_type {};
+
 }
 
 #endif
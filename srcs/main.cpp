@@ -3,9 +3,13 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <cstdlib>
 #include <ctime>
 #include <deque>
+#include <limits>
 #include <list>
+#include <new>
+#include <stdexcept>
 #include <utility>
 
 #if STL
@@ -16,9 +20,19 @@
   namespace ft = std;
 #else
   #include "vector.hpp"
+  #include "small_vector.hpp"
   #include "stack.hpp"
   #include "map.hpp"
   #include "set.hpp"
+  #include "btree_map.hpp"
+  #include "btree_set.hpp"
+#endif
+
+// BTREE runs the map and set tests against btree_map and btree_set
+
+#if BTREE && !STL
+  #define map btree_map
+  #define set btree_set
 #endif
 
 clock_t time_start, time_end;
@@ -57,6 +71,96 @@ static void destructor() {
 }
 #endif
 
+// Counts the calls to operator new, to tell which operations allocate
+
+std::size_t new_calls = 0;
+
+#if __cplusplus < 201103L
+void* operator new(std::size_t __n) throw(std::bad_alloc) {
+#else
+void* operator new(std::size_t __n) {
+#endif
+  ++new_calls;
+  void* __p = std::malloc(__n != 0 ? __n : 1);
+  if (__p == NULL) {
+    throw std::bad_alloc();
+  }
+  return __p;
+}
+
+#if __cplusplus < 201103L
+void operator delete(void* __p) throw() {
+#else
+void operator delete(void* __p) noexcept {
+#endif
+  std::free(__p);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void* __p, std::size_t) noexcept {
+  std::free(__p);
+}
+#endif
+
+#if !STL
+// Black height of the tree whose end() is __end, counting nil as black, or 0
+// if a red and black invariant is broken: a red root, a red child of a red
+// node, or two paths down to nil with different numbers of black nodes.
+// __color() is 1 for black
+
+template <class _Node>
+std::size_t black_height(_Node* __x) {
+  std::size_t __l = __x->__has_left() ? black_height(__x->__left_) : 1;
+  std::size_t __r = __x->__has_right() ? black_height(__x->__right_) : 1;
+  bool __red_child = (__x->__has_left() && __x->__left_->__color() == 0)
+                     || (__x->__has_right() && __x->__right_->__color() == 0);
+  if (__l == 0 || __l != __r || (__x->__color() == 0 && __red_child)) {
+    return 0;
+  }
+  return __l + static_cast<std::size_t>(__x->__color());
+}
+
+template <class _Iter>
+std::size_t tree_black_height(_Iter __end) {
+  typename _Iter::node_pointer __root = __end.base()->__parent();
+  if (__root->__is_nil()) {
+    return 1;
+  }
+  return __root->__color() == 0 ? 0 : black_height(__root);
+}
+
+template <class _Node>
+std::size_t count_nodes(_Node* __x) {
+  return 1 + (__x->__has_left() ? count_nodes(__x->__left_) : 0)
+           + (__x->__has_right() ? count_nodes(__x->__right_) : 0);
+}
+
+// Whether the tree of __c is a red and black tree holding the values of __v
+// in order, as found going forward, backward and down the child links
+
+template <class _Set, class _Vector>
+bool sorted_tree_valid(const _Set& __c, const _Vector& __v) {
+  typename _Set::const_iterator::node_pointer __root = __c.end().base()->__parent();
+  if (tree_black_height(__c.end()) == 0 || __c.size() != __v.size()
+      || (__root->__is_nil() ? __v.size() != 0 : count_nodes(__root) != __v.size())) {
+    return false;
+  }
+  typename _Set::const_iterator __it = __c.begin();
+  for (std::size_t __i = 0; __i < __v.size(); ++__i, ++__it) {
+    if (__it == __c.end() || *__it != __v[__i]) {
+      return false;
+    }
+  }
+  typename _Set::const_reverse_iterator __rit = __c.rbegin();
+  for (std::size_t __i = __v.size(); __i != 0; --__i, ++__rit) {
+    if (__rit == __c.rend() || *__rit != __v[__i - 1]) {
+      return false;
+    }
+  }
+  return __it == __c.end() && __rit == __c.rend();
+}
+#endif
+
 bool fncomp (char lhs, char rhs) {return lhs<rhs;}
 
 struct classcomp {
@@ -64,6 +168,73 @@ struct classcomp {
   {return lhs<rhs;}
 };
 
+struct Record {
+  int idx;
+  char tag[8];
+};
+
+// Transparent comparator taking C strings and prefixes as well as strings.
+// mixed_calls counts the comparisons made without building a string.
+
+struct prefix {
+  explicit prefix(const char* p) : str(p) {}
+  std::string str;
+};
+
+struct string_less {
+  typedef void is_transparent;
+
+  static int mixed_calls;
+
+  bool operator()(const std::string& lhs, const std::string& rhs) const { return lhs < rhs; }
+  bool operator()(const std::string& lhs, const char* rhs) const { ++mixed_calls; return lhs.compare(rhs) < 0; }
+  bool operator()(const char* lhs, const std::string& rhs) const { ++mixed_calls; return rhs.compare(lhs) > 0; }
+  bool operator()(const std::string& lhs, const prefix& rhs) const { return lhs.compare(0, rhs.str.size(), rhs.str) < 0; }
+  bool operator()(const prefix& lhs, const std::string& rhs) const { return rhs.compare(0, lhs.str.size(), lhs.str) > 0; }
+};
+
+int string_less::mixed_calls = 0;
+
+// Mapped value counting how many times it is constructed
+
+struct Counted {
+  static int made;
+
+  Counted() : n(0) { ++made; }
+  Counted(int v) : n(v) { ++made; }
+  Counted(const Counted& x) : n(x.n) { ++made; }
+  Counted& operator=(const Counted& x) { n = x.n; return *this; }
+
+  int n;
+};
+
+int Counted::made = 0;
+
+struct add_to {
+  explicit add_to(int v) : v(v) {}
+  void operator()(Counted& c) const { c.n += v; }
+  void operator()(int& n) const { n += v; }
+  int v;
+};
+
+#if __cplusplus >= 201103L
+// Element whose move may throw, so containers must copy it to stay unchanged
+// when a reallocation fails. Copies throw once copies_left runs out.
+
+struct Fragile {
+  static int copies_left;
+
+  Fragile(int v) : n(v) {}
+  Fragile(const Fragile& x) : n(x.n) { if (copies_left-- == 0) throw std::runtime_error("copy"); }
+  Fragile(Fragile&& x) noexcept(false) : n(x.n) { x.n = -1; }
+  Fragile& operator=(const Fragile& x) { n = x.n; return *this; }
+
+  int n;
+};
+
+int Fragile::copies_left = -1;
+#endif
+
 int main() {
 
   std::cout << "=====Vector test=====\n" << std::endl;
@@ -699,6 +870,316 @@ int main() {
     ft::vector<int> v(isIt, isItEnd);
     print_container(v.begin(), v.end());
 
+    std::ostringstream oss;
+    for (int i=0; i<20000; ++i) oss << i << ' ';
+    std::istringstream bulk(oss.str());
+    v.insert(v.begin() + 1, std::istream_iterator<int>(bulk), isItEnd);
+    std::istringstream tail("-1 -2");
+    v.insert(v.end(), std::istream_iterator<int>(tail), isItEnd);
+    std::istringstream none("");
+    v.insert(v.begin(), std::istream_iterator<int>(none), isItEnd);
+    std::cout << "size: " << v.size() << '\n';
+    print_container(v.begin(), v.begin() + 5);
+    print_container(v.end() - 5, v.end());
+
+    end_test(title);
+  }
+  {
+    std::string title = "trivially copyable elements test";
+    start_test(title);
+
+    ft::vector<Record> records;
+    for (int i=0; i<10; i++) {
+      Record r;
+      r.idx = i;
+      r.tag[0] = static_cast<char>('a' + i);
+      records.push_back(r);
+    }
+    Record mid;
+    mid.idx = 100;
+    mid.tag[0] = 'z';
+    records.insert(records.begin() + 3, 2, mid);
+    records.erase(records.begin() + 7);
+    records.erase(records.begin(), records.begin() + 2);
+    records.reserve(100);
+
+    ft::vector<Record> copied(records);
+    ft::vector<Record> assigned(3);
+    assigned = copied;
+    copied.insert(copied.begin() + 1, records.begin(), records.begin() + 4);
+
+    std::cout << "assigned contains:";
+    for (ft::vector<Record>::iterator it = assigned.begin(); it != assigned.end(); ++it)
+      std::cout << ' ' << it->idx << it->tag[0];
+    std::cout << '\n';
+    std::cout << "copied contains:";
+    for (ft::vector<Record>::iterator it = copied.begin(); it != copied.end(); ++it)
+      std::cout << ' ' << it->idx << it->tag[0];
+    std::cout << '\n';
+
+    ft::vector<std::string> strings(3, "str");
+    strings.insert(strings.begin() + 1, "mid");
+    strings.erase(strings.begin());
+    print_container(strings.begin(), strings.end());
+
+    end_test(title);
+  }
+  {
+    std::string title = "growth policy test";
+    start_test(title);
+
+    // Capacities differ between policies, so only their invariants are printed
+#if STL
+    typedef ft::vector<int> vector_1_5;
+    typedef ft::vector<int> vector_fixed;
+    typedef ft::vector<char> vector_paged;
+#else
+    typedef ft::vector<int, std::allocator<int>, ft::growth_factor_1_5> vector_1_5;
+    typedef ft::vector<int, std::allocator<int>, ft::growth_fixed<8> > vector_fixed;
+    typedef ft::vector<char, std::allocator<char>, ft::growth_page_aligned<> > vector_paged;
+#endif
+    vector_1_5 foo;
+    vector_fixed bar;
+    vector_paged baz;
+    bool fits = true;
+    for (int i=0; i<100; ++i) {
+      foo.push_back(i);
+      bar.insert(bar.begin(), i);
+      baz.insert(baz.end(), 50, static_cast<char>('a' + i % 26));
+      fits = fits && foo.size() <= foo.capacity() && bar.size() <= bar.capacity()
+             && baz.size() <= baz.capacity();
+    }
+    std::cout << "capacities fit: " << fits << '\n';
+    std::cout << "foo: " << foo.size() << ' ' << foo.front() << ' ' << foo.back() << '\n';
+    std::cout << "bar: " << bar.size() << ' ' << bar.front() << ' ' << bar.back() << '\n';
+    std::cout << "baz: " << baz.size() << ' ' << baz.front() << ' ' << baz.back() << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "reallocating allocator test";
+    start_test(title);
+
+#if STL
+    typedef ft::vector<int> mapped_vector;
+#else
+    // A low threshold so that both the malloc and the mmap paths are taken
+    typedef ft::vector<int, ft::mmap_allocator<int, 4096> > mapped_vector;
+#endif
+    mapped_vector v;
+    for (int i=0; i<100000; ++i) v.push_back(i);
+    v.insert(v.begin() + 10, 3, v[5]);
+    mapped_vector head(v.begin() + 99990, v.end());
+    v.insert(v.begin(), head.begin(), head.end());
+    v.reserve(300000);
+    v.erase(v.begin() + 20, v.begin() + 50000);
+
+    long sum = 0;
+    for (mapped_vector::iterator it = v.begin(); it != v.end(); ++it) sum += *it;
+    std::cout << "size: " << v.size() << '\n';
+    std::cout << "sum: " << sum << '\n';
+    print_container(v.begin(), v.begin() + 20);
+
+    mapped_vector copy(v);
+    std::cout << "copy is equal: " << (copy == v) << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "zeroed allocation test";
+    start_test(title);
+
+#if STL
+    typedef ft::vector<long> counter_vector;
+#else
+    typedef ft::vector<long, ft::mmap_allocator<long, 4096> > counter_vector;
+#endif
+    counter_vector counts(100000);
+    for (int i=0; i<100000; i+=997) counts[i] = i;
+    counts.resize(10);
+    counts.resize(50000);
+    counts.resize(400000);
+    counts[399999] = 7;
+    counter_vector small(3, 0);
+    small.resize(100, 0);
+
+    long sum = 0;
+    for (counter_vector::iterator it = counts.begin(); it != counts.end(); ++it) sum += *it;
+    for (counter_vector::iterator it = small.begin(); it != small.end(); ++it) sum += *it;
+    std::cout << "size: " << counts.size() << ' ' << small.size() << '\n';
+    std::cout << "sum: " << sum << '\n';
+    print_container(counts.begin(), counts.begin() + 12);
+
+    end_test(title);
+  }
+  {
+    std::string title = "uninitialized append test";
+    start_test(title);
+
+    std::istringstream input("The quick brown fox jumps over the lazy dog");
+    ft::vector<char> buf;
+    while (input) {
+      ft::vector<char>::size_type off = buf.size();
+#if STL
+      buf.resize(off + 8);
+#else
+      buf.append_uninitialized(8);
+#endif
+      input.read(&buf[off], 8);
+#if STL
+      buf.resize(off + input.gcount());
+#else
+      buf.resize_default_init(off + input.gcount());
+#endif
+    }
+    std::cout << "read: " << std::string(buf.begin(), buf.end()) << '\n';
+    std::cout << "size: " << buf.size() << '\n';
+
+    ft::vector<std::string> names(2, "x");
+#if STL
+    names.resize(4);
+#else
+    names.resize_default_init(4);
+#endif
+    std::cout << "names: " << names.size() << " [" << names[3] << "]\n";
+
+    end_test(title);
+  }
+  {
+    std::string title = "contiguous comparison test";
+    start_test(title);
+
+    ft::vector<char> c1(3000, 'a'), c2(3000, 'a');
+    std::cout << (c1 == c2) << (c1 < c2) << (c2 < c1) << '\n';
+    c2[2500] = static_cast<char>(-5);   // negative for a signed char
+    std::cout << (c1 == c2) << (c1 < c2) << (c2 < c1) << '\n';
+
+    ft::vector<unsigned char> u1(1000, 200), u2(1000, 200);
+    u2[999] = 10;
+    std::cout << (u1 == u2) << (u1 < u2) << (u2 < u1) << '\n';
+    u2.pop_back();
+    std::cout << (u1 == u2) << (u1 < u2) << (u2 < u1) << '\n';
+
+    ft::vector<int> i1(5000, 1), i2(5000, 1);
+    i1[4097] = -1;
+    std::cout << (i1 == i2) << (i1 < i2) << (i2 < i1) << (i1 >= i2) << '\n';
+    i1[4097] = 1;
+    i1.push_back(0);
+    std::cout << (i1 == i2) << (i1 < i2) << (i2 < i1) << (i1 > i2) << '\n';
+
+    ft::vector<long> empty1, empty2, l1(1, 0);
+    std::cout << (empty1 == empty2) << (empty1 < empty2) << (empty1 < l1) << (l1 < empty1) << '\n';
+
+    ft::vector<double> d1(4, 0.0), d2(4, -0.0);
+    std::cout << (d1 == d2) << (d1 < d2) << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "nested containers test";
+    start_test(title);
+
+    ft::vector<ft::vector<int> > nested;
+    for (int i=0; i<20; ++i) nested.push_back(ft::vector<int>(i % 5, i));
+    nested.insert(nested.begin() + 3, 2, ft::vector<int>(2, -1));
+    nested.insert(nested.begin() + 1, nested.begin() + 10, nested.begin() + 12);
+    nested.reserve(200);
+    nested.insert(nested.begin(), nested.back());
+
+    for (ft::vector<ft::vector<int> >::iterator it = nested.begin(); it != nested.end(); ++it)
+      print_container(it->begin(), it->end());
+
+    ft::vector<ft::map<int, std::string> > maps(2);
+    for (int i=0; i<10; ++i) {
+      ft::map<int, std::string> m;
+      m[i] = std::string(static_cast<size_t>(i), '*');
+      maps.push_back(m);
+    }
+    maps.reserve(100);
+    std::cout << "maps:";
+    for (size_t i=0; i<maps.size(); ++i)
+      std::cout << ' ' << maps[i].size() << (maps[i].empty() ? "" : maps[i].begin()->second);
+    std::cout << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "small_vector test";
+    start_test(title);
+
+#if STL
+    typedef ft::vector<std::string> small_strings;
+#else
+    typedef ft::small_vector<std::string, 4> small_strings;
+#endif
+    small_strings foo;
+    for (int i=0; i<3; ++i) foo.push_back(std::string(1, static_cast<char>('a' + i)));
+    small_strings bar(foo);
+    bar.insert(bar.begin() + 1, 3, "x");     // grows past the inline buffer
+    bar.erase(bar.begin());
+    foo.swap(bar);
+    foo.resize(8, "y");
+    bar.insert(bar.end(), foo.begin(), foo.begin() + 2);
+    small_strings baz;
+    baz = foo;
+
+    std::cout << "foo contains:";
+    print_container(foo.begin(), foo.end());
+    std::cout << "bar contains:";
+    print_container(bar.begin(), bar.end());
+    std::cout << "baz contains:";
+    print_container(baz.rbegin(), baz.rend());
+    std::cout << "foo == baz: " << (foo == baz) << '\n';
+    std::cout << "foo < bar: " << (foo < bar) << '\n';
+    std::cout << "bar.at(4): " << bar.at(4) << '\n';
+
+    small_strings one(1, "one");
+    small_strings three(3, "three");
+    one.swap(three);                         // both inline, sizes differ
+    three.swap(foo);                         // inline with heap
+    foo.swap(three);
+    std::cout << "one contains:";
+    print_container(one.begin(), one.end());
+    std::cout << "three contains:";
+    print_container(three.begin(), three.end());
+    std::cout << "foo contains:";
+    print_container(foo.begin(), foo.end());
+
+    end_test(title);
+  }
+  {
+    std::string title = "small_vector benchmark";
+    start_test(title);
+
+#if STL
+    typedef ft::vector<int> small_ints;
+#else
+    typedef ft::small_vector<int, 8> small_ints;
+#endif
+    long sum = 0;
+    for (int i=0; i<200000; ++i) {
+      small_ints v;
+      for (int j=0; j<=i % 8; ++j) v.push_back(j);
+      small_ints w(v);
+      sum += w.back() + static_cast<long>(w.size());
+    }
+    std::cout << "sum: " << sum << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "small_vector benchmark (vector baseline)";
+    start_test(title);
+
+    long sum = 0;
+    for (int i=0; i<200000; ++i) {
+      ft::vector<int> v;
+      for (int j=0; j<=i % 8; ++j) v.push_back(j);
+      ft::vector<int> w(v);
+      sum += w.back() + static_cast<long>(w.size());
+    }
+    std::cout << "sum: " << sum << '\n';
+
     end_test(title);
   }
 
@@ -1484,6 +1965,790 @@ int main() {
 
     end_test(title);
   }
+  {
+    std::string title = "red black invariant test";
+    start_test(title);
+
+    // Random inserts and erases, with the invariants checked after each one
+    ft::map<int, int> m;
+    ft::set<int> st;
+    bool valid = true;
+    unsigned long seed = 12345;
+    long checksum = 0;
+    for (int step=0; step<20000; ++step) {
+      seed = seed * 1103515245 + 12345;
+      int key = static_cast<int>((seed >> 16) % 512);
+      if ((seed >> 8) % 3 == 0) {
+        checksum += static_cast<long>(m.erase(key) + st.erase(key));
+      } else {
+        m[key] = step;
+        st.insert(key);
+      }
+#if !STL && !BTREE
+      valid = valid && tree_black_height(m.end()) != 0 && tree_black_height(st.end()) != 0;
+#endif
+    }
+    for (ft::map<int, int>::iterator it = m.begin(); it != m.end(); ++it) checksum += it->first * 3 + it->second;
+    std::cout << "sizes: " << m.size() << ' ' << st.size() << '\n';
+    std::cout << "checksum: " << checksum << '\n';
+    std::cout << "invariants hold: " << valid << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "node pool test";
+    start_test(title);
+
+    ft::map<int, std::string> pooled;
+    for (int i=0; i<1000; ++i) pooled[(i * 37) % 1000] = std::string(1, static_cast<char>('a' + i % 26));
+    for (int i=0; i<1000; i+=3) pooled.erase(i);
+    for (int i=0; i<1000; i+=6) pooled[i] = "z";
+
+    ft::map<int, std::string> copy(pooled);
+    ft::map<int, std::string> assigned;
+    assigned[-1] = "gone";
+    assigned = copy;
+    pooled.swap(assigned);
+    ft::map<int, std::string, std::less<int>, std::allocator<ft::pair<const int, std::string> > >
+      plain(pooled.begin(), pooled.end());
+
+#if STL || BTREE
+    bool consistent = true;
+#else
+    // Every node comes from the pool, in a few slabs
+    ft::pool_stats st = pooled.get_allocator().stats();
+    bool consistent = st.chunks_in_use == pooled.size() && st.slabs < 10
+                      && copy.get_allocator() != pooled.get_allocator();
+
+    // A copy made before the first allocation shares the pool it ends up using
+    ft::pool_allocator<int> first;
+    ft::pool_allocator<int> early(first);
+    int* chunk = first.allocate(1);
+    early.deallocate(chunk, 1);
+    consistent = consistent && early == first && first.stats().chunks_in_use == 0;
+#endif
+    std::cout << "sizes: " << pooled.size() << ' ' << copy.size() << ' ' << plain.size() << '\n';
+    std::cout << "equal: " << (pooled == copy) << '\n';
+    std::cout << "pool consistent: " << consistent << '\n';
+    for (ft::map<int, std::string>::iterator it = pooled.begin(); it != pooled.end() && it->first < 20; ++it)
+      std::cout << it->first << " => " << it->second << '\n';
+
+    ft::set<int> ints;
+    for (int i=0; i<100; ++i) ints.insert(i % 17);
+    ints.clear();
+    ints.insert(5);
+    std::cout << "set: " << ints.size() << ' ' << *ints.begin() << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "sorted construction test";
+    start_test(title);
+
+    ft::vector<ft::pair<int, int> > sorted;
+    for (int i=0; i<5000; ++i) sorted.push_back(ft::make_pair(i * 2, i));
+
+    // Built bottom-up, then edited to check that the tree is balanced correctly
+    ft::map<int, int> built(sorted.begin(), sorted.end());
+    for (int i=0; i<10000; i+=3) built.erase(i);
+    for (int i=1; i<10000; i+=4) built[i] = -i;
+    long sum = 0;
+    for (ft::map<int, int>::iterator it = built.begin(); it != built.end(); ++it) sum += it->first + it->second;
+    std::cout << "built: " << built.size() << ' ' << sum << ' ' << built.begin()->first << ' ' << built.rbegin()->first << '\n';
+
+    ft::map<int, int> copied(built.begin(), built.end());
+    std::cout << "copied: " << (copied == built) << '\n';
+
+    int keys[] = {-4, 0, 7, 8, 100};
+#if STL
+    ft::map<int, int> tagged(sorted.begin(), sorted.end());
+    ft::set<int> tagged_set(keys, keys + 5);
+#else
+    ft::map<int, int> tagged(ft::sorted_unique, sorted.begin(), sorted.end());
+    ft::set<int> tagged_set(ft::sorted_unique, keys, keys + 5);
+#endif
+    std::cout << "tagged: " << tagged.size() << ' ' << tagged.find(4242)->second << ' ' << tagged_set.size() << '\n';
+
+#if STL || BTREE
+    bool sorted_valid = true;
+#else
+    // Trees built from sorted input, with their links, colors and subtree
+    // data checked for each tree policy
+    typedef ft::set<int, std::less<int>, ft::pool_allocator<int>, ft::tree_threaded> threaded_set;
+    typedef ft::set<int, std::less<int>, ft::pool_allocator<int>,
+                    ft::tree_order_statistic<> > ranked_set;
+    typedef ft::set<int, std::less<int>, ft::pool_allocator<int>,
+                    ft::tree_order_statistic<ft::tree_threaded> > ranked_threaded_set;
+    typedef ft::set<int, std::less<int>, ft::pool_allocator<int>,
+                    ft::tree_aggregate<ft::sum_monoid<long> > > summed_set;
+    bool sorted_valid = true;
+    for (int n=0; n<=300; ++n) {
+      ft::vector<int> v;
+      long total = 0;
+      for (int i=0; i<n; ++i) {
+        v.push_back(i * 3);
+        total += i * 3;
+      }
+      ft::set<int> plain_built(ft::sorted_unique, v.begin(), v.end());
+      threaded_set threaded_built(ft::sorted_unique, v.begin(), v.end());
+      ranked_set ranked_built(ft::sorted_unique, v.begin(), v.end());
+      ranked_threaded_set ranked_threaded_built(ft::sorted_unique, v.begin(), v.end());
+      summed_set summed_built(ft::sorted_unique, v.begin(), v.end());
+      sorted_valid = sorted_valid && sorted_tree_valid(plain_built, v)
+                     && sorted_tree_valid(threaded_built, v) && sorted_tree_valid(ranked_built, v)
+                     && sorted_tree_valid(ranked_threaded_built, v) && sorted_tree_valid(summed_built, v)
+                     && summed_built.aggregate() == total
+                     && ranked_built.nth(static_cast<std::size_t>(n)) == ranked_built.end()
+                     && ranked_threaded_built.nth(static_cast<std::size_t>(n)) == ranked_threaded_built.end();
+      for (int i=0; i<n; ++i) {
+        std::size_t k = static_cast<std::size_t>(i);
+        sorted_valid = sorted_valid && *ranked_built.nth(k) == v[k] && ranked_built.rank(v[k]) == k
+                       && *ranked_threaded_built.nth(k) == v[k] && ranked_threaded_built.rank(v[k]) == k;
+      }
+    }
+#endif
+    std::cout << "sorted trees valid: " << sorted_valid << '\n';
+
+    for (int n=0; n<70; ++n) {
+      ft::vector<int> v;
+      for (int i=0; i<n; ++i) v.push_back(i);
+      ft::set<int> s(v.begin(), v.end());
+      for (int i=0; i<n; i+=2) s.erase(i);
+      for (int i=n; i<2*n; ++i) s.insert(i);
+      std::cout << s.size() << (s.empty() ? 0 : *s.begin() + *s.rbegin()) << ' ';
+    }
+    std::cout << '\n';
+
+    int unsorted[] = {5, 3, 9, 3, 1, 9, 7};
+    ft::set<int> fallback(unsorted, unsorted + 7);
+    std::istringstream stream("1 2 2 3 5 8 13");
+    ft::set<int> streamed((std::istream_iterator<int>(stream)), std::istream_iterator<int>());
+    for (ft::set<int>::iterator it = fallback.begin(); it != fallback.end(); ++it) std::cout << *it << ' ';
+    std::cout << '\n';
+    for (ft::set<int>::iterator it = streamed.begin(); it != streamed.end(); ++it) std::cout << *it << ' ';
+    std::cout << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "node recycling test";
+    start_test(title);
+
+    ft::map<int, std::string> state;
+    ft::map<int, std::string> next;
+    bool consistent = true;
+    for (int tick=0; tick<50; ++tick) {
+      next.clear();
+      for (int i=0; i<100 + tick % 7; ++i) next[(i * 7 + tick) % 211] = std::string(tick % 5 + 1, 'x');
+      state = next;
+#if !STL && !BTREE
+      // The pool never needs more chunks than the larger of the two contents
+      ft::pool_stats st = state.get_allocator().stats();
+      consistent = consistent && state.capacity() == state.size()
+                   && st.chunks_in_use == state.size();
+#endif
+    }
+    std::cout << "state: " << state.size() << ' ' << (state == next) << ' ' << state.begin()->first << ' ' << state.begin()->second << '\n';
+
+#if STL || BTREE
+    state.clear();
+#else
+    state.reserve(500);
+    consistent = consistent && state.capacity() == 500;
+    state.clear_keep_capacity();
+    consistent = consistent && state.empty() && state.capacity() == 500;
+#endif
+    for (int i=0; i<300; ++i) state.insert(ft::make_pair(i, std::string("y")));
+#if !STL && !BTREE
+    consistent = consistent && state.capacity() == 500
+                 && state.get_allocator().stats().chunks_in_use == 500;
+#endif
+    state.erase(state.begin(), state.find(290));
+    std::cout << "state: " << state.size() << ' ' << state.begin()->first << ' ' << state.rbegin()->first << '\n';
+    std::cout << "recycling consistent: " << consistent << '\n';
+
+    ft::set<int> small;
+    ft::set<int> large;
+    for (int i=0; i<1000; ++i) large.insert(i);
+    small.insert(1);
+    small = large;
+    large = small;
+    large.insert(-1);
+    std::cout << "sets: " << small.size() << ' ' << large.size() << ' ' << *large.begin() << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "empty container test";
+    start_test(title);
+
+    ft::vector<ft::map<int, std::string> > attributes(1000);
+    std::size_t calls = new_calls;
+    ft::map<int, std::string> empty;
+    ft::set<int> empty_set;
+    ft::set<int> set_copy(empty_set);
+    ft::map<int, std::string> copy(empty);
+    attributes[3].swap(copy);
+    attributes[7] = empty;
+    bool allocation_free = new_calls == calls;
+    std::cout << "lookups: " << empty.count(1) << ' ' << (empty.find(1) == empty.end())
+              << ' ' << (empty.lower_bound(1) == empty.end()) << ' ' << (empty.upper_bound(1) == empty.begin())
+              << ' ' << (empty.rbegin() == empty.rend()) << ' ' << empty.erase(1) << '\n';
+
+    attributes[9][4] = "four";
+    attributes[9].clear();
+    attributes[11][2] = "two";
+    attributes[12] = attributes[11];
+    attributes[11] = empty;
+#if !STL && !BTREE
+    allocation_free = allocation_free && attributes[9].get_allocator().stats().chunks_in_use == 0;
+#endif
+    std::cout << "allocation free: " << allocation_free << '\n';
+
+    // end() stays the same from construction on, through clear()
+    ft::map<int, std::string> fresh;
+    ft::map<int, std::string>::iterator first_end = fresh.end();
+    fresh[1] = "one";
+    ft::map<int, std::string>::iterator filled_end = fresh.end();
+    fresh.clear();
+    fresh[2] = "two";
+    fresh.erase(2);
+#if BTREE && !STL
+    bool end_kept = true;                    // insertions invalidate b-tree iterators
+#else
+    bool end_kept = filled_end == fresh.end() && first_end == fresh.end();
+    fresh.insert(first_end, ft::make_pair(3, std::string("three")));
+    end_kept = end_kept && fresh.begin()->first == 3 && first_end == fresh.end();
+#endif
+    std::cout << "end kept: " << end_kept << '\n';
+
+    size_t total = 0;
+    for (size_t i=0; i<attributes.size(); ++i) total += attributes[i].size();
+    std::cout << "total: " << total << ' ' << attributes[12][2] << '\n';
+
+    attributes[9].insert(attributes[12].begin(), attributes[12].end());
+    attributes[9].insert(attributes[9].end(), ft::make_pair(5, std::string("five")));
+    for (ft::map<int, std::string>::iterator it = attributes[9].begin(); it != attributes[9].end(); ++it)
+      std::cout << it->first << " => " << it->second << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "large copy test";
+    start_test(title);
+
+    ft::map<int, int> original;
+    for (int i=0; i<100000; ++i) original[i] = i % 97;
+    for (int i=0; i<100000; i+=5) original.erase(i);
+
+    ft::map<int, int> snapshot(original);
+    for (int i=0; i<100000; i+=2) original[i] = -1;
+    ft::map<int, int>::const_reverse_iterator rit = snapshot.rbegin();
+    long sum = 0;
+    for (; rit != snapshot.rend(); ++rit) sum += rit->first - rit->second;
+    std::cout << "snapshot: " << snapshot.size() << ' ' << sum << ' ' << (snapshot == original) << '\n';
+    for (int i=1; i<100000; i+=3) snapshot.erase(i);
+    std::cout << "snapshot: " << snapshot.size() << ' ' << snapshot.begin()->first << ' ' << snapshot.count(99998) << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "threaded tree test";
+    start_test(title);
+
+#if STL || BTREE
+    typedef ft::map<int, std::string> threaded_map;
+    typedef ft::set<int> threaded_set;
+#else
+    typedef ft::map<int, std::string, std::less<int>,
+                    ft::pool_allocator<ft::pair<const int, std::string> >,
+                    ft::tree_threaded> threaded_map;
+    typedef ft::set<int, std::less<int>, ft::pool_allocator<int>, ft::tree_threaded> threaded_set;
+#endif
+    threaded_map tm;
+    threaded_set ts;
+    for (int i=0; i<2000; ++i) {
+      int k = (i * 7919) % 1009;
+      tm.insert(tm.lower_bound(k), ft::make_pair(k, std::string(k % 4 + 1, 'a' + k % 26)));
+      ts.insert(k);
+      if (i % 3 == 0) {
+        tm.erase((k * 31) % 1009);
+        ts.erase(ts.lower_bound((k * 31) % 1009), ts.upper_bound((k * 31) % 1009 + 2));
+      }
+    }
+    long forward = 0;
+    long backward = 0;
+    for (threaded_map::iterator it = tm.begin(); it != tm.end(); ++it) forward += it->first * static_cast<long>(it->second.size());
+    for (threaded_map::reverse_iterator rit = tm.rbegin(); rit != tm.rend(); ++rit) backward += rit->first * static_cast<long>(rit->second.size());
+    std::cout << "map: " << tm.size() << ' ' << forward << ' ' << (forward == backward) << '\n';
+
+    threaded_set copy(ts);
+    threaded_set sorted(copy.begin(), copy.end());
+    threaded_set::iterator sit = sorted.find(500);
+    if (sit != sorted.end()) {
+      --sit;
+      std::cout << "around 500: " << *sit << ' ' << *++++sit << '\n';
+    }
+    print_container(ts.lower_bound(990), ts.end());
+    std::cout << "sets: " << copy.size() << ' ' << (copy == ts) << ' ' << (sorted == ts) << ' ' << *sorted.rbegin() << '\n';
+    sorted.clear();
+    sorted.insert(3);
+    std::cout << "cleared: " << sorted.size() << ' ' << *sorted.begin() << ' ' << *--sorted.end() << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "reverse iteration test";
+    start_test(title);
+
+    ft::map<int, std::string> latest;
+    for (int i=0; i<50; ++i) latest[i * 3] = std::string(1, static_cast<char>('a' + i % 26));
+
+    ft::map<int, std::string>::reverse_iterator rit = latest.rbegin();
+    for (int i=0; i<5; ++i, ++rit) std::cout << rit->first << " => " << rit->second << '\n';
+    rit->second = "updated";
+    ft::map<int, std::string>::const_reverse_iterator crit = rit;
+    std::cout << "converted: " << (crit == rit) << ' ' << crit->first << ' ' << (*crit).second << '\n';
+    int before = (rit++)->first;
+    int after = rit->first;
+    std::cout << "postfix: " << before << ' ' << after;
+    before = (rit--)->first;
+    std::cout << ' ' << before << ' ' << rit->first << '\n';
+    --rit;
+    before = rit->first;
+    ++rit;
+    std::cout << "prefix: " << before << ' ' << rit->first << ' ' << (++rit)->first << '\n';
+    std::cout << "base: " << rit.base()->first << ' ' << (rit.base() == latest.find(rit->first + 3)) << '\n';
+
+    // Erase the even keys while going backwards, making the reverse iterator
+    // again from its base, taken before erasing the element it points at
+    for (rit = latest.rbegin(); rit != latest.rend(); ) {
+      if (rit->first % 2 == 0) {
+#if BTREE && !STL
+        // Erasing from a B-tree moves elements, so find the place again
+        int key = rit->first;
+        latest.erase(key);
+        rit = ft::map<int, std::string>::reverse_iterator(latest.lower_bound(key));
+#else
+        ft::map<int, std::string>::iterator next = rit.base();
+        latest.erase(--rit.base());
+        rit = ft::map<int, std::string>::reverse_iterator(next);
+#endif
+      } else {
+        ++rit;
+      }
+    }
+    ft::map<int, std::string>::const_reverse_iterator last = latest.rend();
+    --last;
+    std::cout << "remaining: " << latest.size() << ' ' << latest.rbegin()->first << ' ' << last->first << '\n';
+
+    // Inserting between a reverse iterator and its base: the std one moves onto
+    // the new element, the tree one stays on its node and takes the new
+    // element as base. Either way it points right before its base.
+    ft::map<int, std::string>::reverse_iterator mid(latest.find(15));
+    ft::map<int, std::string>::reverse_iterator top = latest.rbegin();
+    std::cout << "before insert: " << mid->first << ' ' << top->first << '\n';
+    latest[12] = "twelve";
+    latest[148] = "top";
+#if BTREE && !STL
+    // b-tree insertions invalidate iterators
+    mid = ft::map<int, std::string>::reverse_iterator(latest.find(15));
+    top = latest.rbegin();
+#endif
+    ft::map<int, std::string>::iterator mid_base = mid.base();
+    ft::map<int, std::string>::iterator top_base = top.base();
+    bool before_base = &*mid == &*--mid_base && &*top == &*--top_base;
+#if STL || BTREE
+    bool followed = mid->first == 12 && mid->second == "twelve" && top->first == 148
+                    && mid.base()->first == 15 && top.base() == latest.end();
+#else
+    bool followed = mid->first == 9 && mid->second == "d" && top->first == 147
+                    && mid.base()->first == 12 && top.base()->first == 148;
+#endif
+    std::cout << "after insert: " << before_base << ' ' << followed << '\n';
+
+    ft::set<int> ids;
+    for (int i=0; i<20; ++i) ids.insert(i * i % 17);
+    print_container(ids.rbegin(), ids.rend());
+    ft::set<int>::const_reverse_iterator sit = ids.rend();
+    int smallest = *--sit;
+    std::cout << "set: " << smallest << ' ' << *--sit << ' ' << (sit.base() == ++ids.begin()) << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "unique key lookup test";
+    start_test(title);
+
+    ft::map<int, int> squares;
+    for (int i=0; i<1000; i+=2) squares[i] = i * i;
+    const ft::map<int, int>& csquares = squares;
+    int probes[] = {-1, 0, 1, 500, 501, 998, 999, 2000};
+    for (int i=0; i<8; ++i) {
+      ft::pair<ft::map<int, int>::iterator, ft::map<int, int>::iterator> range = squares.equal_range(probes[i]);
+      ft::pair<ft::map<int, int>::const_iterator, ft::map<int, int>::const_iterator> crange = csquares.equal_range(probes[i]);
+      std::cout << probes[i] << ": " << squares.count(probes[i]) << ' ' << (range.first == range.second)
+                << ' ' << (range.first == squares.lower_bound(probes[i])) << ' ' << (range.second == squares.upper_bound(probes[i]))
+                << ' ' << (crange.first == range.first) << ' ' << (crange.second == range.second)
+                << ' ' << (range.second == squares.end() ? -1 : range.second->first) << '\n';
+    }
+    size_t erased = 0;
+    for (int i=-10; i<1010; i+=3) erased += squares.erase(i);
+    std::cout << "erased: " << erased << ' ' << squares.size() << ' ' << squares.count(6) << ' ' << squares.count(8) << '\n';
+
+    ft::set<std::string> words;
+    words.insert("beta");
+    words.insert("alpha");
+    std::cout << "words: " << words.erase("gamma") << ' ' << words.erase("alpha") << ' ' << words.count("beta")
+              << ' ' << (words.equal_range("beta").second == words.end()) << ' ' << words.size() << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "transparent lookup test";
+    start_test(title);
+
+    ft::map<std::string, int, string_less> fields;
+    const char* names[] = {"abc", "abd", "abe", "b", "ba", "content-length", "content-type", "host"};
+    for (int i=0; i<8; ++i) fields[names[i]] = i;
+    const ft::map<std::string, int, string_less>& cfields = fields;
+
+    std::cout << "find: " << fields.find("host")->second << ' ' << (fields.find("hos") == fields.end())
+              << ' ' << cfields.find("content-type")->second << '\n';
+    std::cout << "count: " << fields.count("ba") << ' ' << fields.count("bb") << '\n';
+    std::cout << "bounds: " << fields.lower_bound("abd")->first << ' ' << fields.upper_bound("abd")->first
+              << ' ' << cfields.lower_bound("c")->first << ' ' << (cfields.upper_bound("z") == cfields.end()) << '\n';
+    std::cout << "equal_range: " << fields.equal_range("b").first->first << ' ' << cfields.equal_range("b").second->first << '\n';
+    std::cout << "erase: " << fields.erase("abe") << ' ' << fields.erase("abe") << ' ' << fields.size() << '\n';
+
+    bool consistent = true;
+#if !STL
+    // No string was built to look up a C string, and a prefix is equivalent
+    // to all the keys starting with it
+    consistent = string_less::mixed_calls > 0;
+    ft::pair<ft::map<std::string, int, string_less>::iterator,
+             ft::map<std::string, int, string_less>::iterator> content = fields.equal_range(prefix("content-"));
+    consistent = consistent && content.first == fields.find("content-length")
+                 && content.second == fields.find("host") && fields.count(prefix("ab")) == 2
+                 && cfields.lower_bound(prefix("b"))->first == "b" && cfields.upper_bound(prefix("b"))->first == "content-length";
+    consistent = consistent && fields.erase(prefix("content")) == 2 && fields.erase(prefix("zz")) == 0;
+#else
+    fields.erase("content-length");
+    fields.erase("content-type");
+#endif
+    std::cout << "transparent consistent: " << consistent << '\n';
+    ft::set<std::string, string_less> name_set(names, names + 8);
+    print_container(name_set.lower_bound("abe"), name_set.upper_bound("c"));
+    for (ft::map<std::string, int, string_less>::iterator it = fields.begin(); it != fields.end(); ++it)
+      std::cout << it->first << " => " << it->second << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "lookup-first insertion test";
+    start_test(title);
+
+    ft::map<int, Counted> counters;
+    for (int i=0; i<1000; ++i) counters[i % 10].n += i;
+    int made = Counted::made;
+    for (int i=0; i<1000; ++i) counters[i % 10].n -= 1;
+    bool consistent = Counted::made == made;
+    std::cout << "counters: " << counters.size() << ' ' << counters[0].n << ' ' << counters[9].n << '\n';
+
+    ft::map<int, std::string> names;
+    names[1] = "one";
+#if STL
+    bool tried = names.insert(ft::make_pair(1, std::string("uno"))).second;
+    bool tried2 = names.insert(ft::make_pair(2, std::string("two"))).second;
+    bool assigned = !names.insert(ft::make_pair(1, std::string("ein"))).second;
+    names[1] = "ein";
+    bool assigned2 = names.insert(ft::make_pair(3, std::string("three"))).second;
+#else
+    bool tried = names.try_emplace(1, "uno").second;
+    bool tried2 = names.try_emplace(2, "two").second;
+    bool assigned = !names.insert_or_assign(1, "ein").second;
+    bool assigned2 = names.insert_or_assign(3, std::string("three")).second;
+    consistent = consistent && names.try_emplace(4).first->second.empty();
+    names.erase(4);
+#endif
+    std::cout << "tried: " << tried << ' ' << tried2 << ' ' << assigned << ' ' << assigned2 << '\n';
+    for (ft::map<int, std::string>::iterator it = names.begin(); it != names.end(); ++it)
+      std::cout << it->first << " => " << it->second << '\n';
+
+    ft::map<std::string, int> volumes;
+    const char* trades[] = {"ab", "cd", "ab", "ef", "ab", "cd"};
+    for (int i=0; i<6; ++i) {
+#if STL
+      volumes[trades[i]] += 10 * (i + 1);
+#else
+      volumes.upsert(trades[i], add_to(10 * (i + 1)));
+#endif
+    }
+    for (ft::map<std::string, int>::iterator it = volumes.begin(); it != volumes.end(); ++it)
+      std::cout << it->first << " => " << it->second << '\n';
+
+#if !STL
+    // Hits build nothing, misses build the mapped value once
+    made = Counted::made;
+    ft::pair<ft::map<int, Counted>::iterator, bool> hit = counters.upsert(3, add_to(1000));
+    ft::pair<ft::map<int, Counted>::iterator, bool> miss = counters.upsert(42, add_to(7));
+    consistent = consistent && !hit.second && hit.first->second.n == counters[3].n && miss.second
+                 && miss.first->second.n == 7 && !counters.try_emplace(42, 1).second
+                 && !counters.insert_or_assign(42, Counted(8)).second && counters[42].n == 8;
+    counters.erase(42);
+    counters[3].n -= 1000;
+#endif
+    std::cout << "lookup-first consistent: " << consistent << ' ' << counters.size() << ' ' << counters[3].n << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "order statistic test";
+    start_test(title);
+
+#if STL || BTREE
+    typedef ft::set<int> ranked_set;
+    typedef ft::map<int, std::string> ranked_map;
+#else
+    typedef ft::set<int, std::less<int>, ft::pool_allocator<int>,
+                    ft::tree_order_statistic<> > ranked_set;
+    typedef ft::map<int, std::string, std::less<int>,
+                    ft::pool_allocator<ft::pair<const int, std::string> >,
+                    ft::tree_order_statistic<ft::tree_threaded> > ranked_map;
+#endif
+    ranked_set scores;
+    for (int i=0; i<3000; ++i) {
+      scores.insert((i * 7919) % 2003);
+      if (i % 4 == 0) scores.erase((i * 31) % 2003);
+    }
+    ranked_set ranked_copy(scores);
+    ranked_copy.erase(ranked_copy.lower_bound(100), ranked_copy.lower_bound(200));
+    const int positions[] = {0, 1, 7, 500, 1000};
+    for (int i=0; i<5; ++i) {
+      ranked_set::iterator it = scores.begin();
+      ranked_set::iterator jt = ranked_copy.begin();
+      ft::advance(it, positions[i]);
+      ft::advance(jt, positions[i]);
+#if STL || BTREE
+      std::size_t rank = ft::distance(scores.begin(), scores.lower_bound(*it + 1));
+      bool same = true;
+#else
+      std::size_t rank = scores.rank(*it + 1);
+      bool same = scores.nth(positions[i]) == it && ranked_copy.nth(positions[i]) == jt;
+#endif
+      std::cout << "nth " << positions[i] << ": " << *it << ' ' << *jt << ' ' << rank << ' ' << same << '\n';
+    }
+    ranked_set::iterator last = scores.end();
+    ft::advance(last, -20);
+    ranked_set::iterator back = last;
+    ft::advance(back, -3);
+    std::cout << "from end: " << *last << ' ' << *back << ' ' << ft::distance(last, scores.end()) << ' '
+              << ft::distance(scores.begin(), last) << ' ' << ft::distance(ranked_copy.begin(), ranked_copy.end()) << '\n';
+
+    ranked_map board;
+    for (int i=0; i<200; ++i) board[(i * 37) % 211] = std::string(1, static_cast<char>('a' + i % 26));
+    for (int i=0; i<200; i += 3) board.erase((i * 37) % 211);
+    ranked_map::const_iterator median = board.begin();
+    ft::advance(median, static_cast<long>(board.size() / 2));
+#if STL || BTREE
+    bool consistent = true;
+#else
+    bool consistent = board.nth(board.size() / 2) == median && board.nth(board.size()) == board.end()
+                      && board.rank(median->first) == board.size() / 2 && board.rank(1000) == board.size();
+#endif
+    std::cout << "median: " << median->first << " => " << median->second << ' '
+              << ft::distance(board.begin(), board.end()) << ' ' << consistent << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "range aggregate test";
+    start_test(title);
+
+#if STL || BTREE
+    typedef ft::map<int, long> volume_map;
+    typedef ft::set<int> price_set;
+#else
+    typedef ft::map<int, long, std::less<int>, ft::pool_allocator<ft::pair<const int, long> >,
+                    ft::tree_aggregate<ft::sum_monoid<long> > > volume_map;
+    typedef ft::set<int, std::less<int>, ft::pool_allocator<int>,
+                    ft::tree_aggregate<ft::max_monoid<int>, ft::tree_threaded> > price_set;
+#endif
+    volume_map volumes;
+    price_set prices;
+    for (int i=0; i<3000; ++i) {
+      int t = (i * 7919) % 4001;
+      volumes.insert(ft::make_pair(t, static_cast<long>(i % 97 + 1)));
+      prices.insert((i * 131) % 2477 - 1000);
+      if (i % 5 == 0) {
+        volumes.erase((i * 31) % 4001);
+        prices.erase((i * 17) % 2477 - 1000);
+      }
+    }
+    volumes[12] += 1000;
+#if !STL && !BTREE
+    volumes.refresh(volumes.find(12));
+#endif
+#if STL
+    volumes[100] = 5000;
+#else
+    volumes.insert_or_assign(100, 5000L);
+#endif
+    const int ranges[][2] = {{0, 4000}, {10, 20}, {100, 100}, {1500, 2500}, {4000, 9000}, {7, 3}};
+    for (int i=0; i<6; ++i) {
+      int lo = ranges[i][0];
+      int hi = ranges[i][1];
+      long total = 0;
+      int highest = std::numeric_limits<int>::min();
+      if (!(hi < lo)) {
+        for (volume_map::iterator it = volumes.lower_bound(lo); it != volumes.upper_bound(hi); ++it)
+          total += it->second;
+        for (price_set::iterator it = prices.lower_bound(lo - 1000); it != prices.upper_bound(hi - 1000); ++it)
+          highest = *it;
+      }
+#if STL || BTREE
+      bool same = true;
+#else
+      int got = prices.aggregate(lo - 1000, hi - 1000);
+      bool same = volumes.aggregate(lo, hi) == total && got == highest;
+#endif
+      std::cout << "range [" << lo << ", " << hi << "]: " << total << ' ' << highest << ' ' << same << '\n';
+    }
+
+    volume_map copy(volumes);
+    copy.erase(copy.begin(), copy.lower_bound(2000));
+    long total = 0;
+    for (volume_map::iterator it = copy.begin(); it != copy.end(); ++it) total += it->second;
+#if STL || BTREE
+    bool consistent = true;
+#else
+    bool consistent = copy.aggregate() == total && volumes.aggregate(2000, 4000) == total;
+#endif
+    std::cout << "copy: " << copy.size() << ' ' << total << ' ' << consistent << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "b-tree test";
+    start_test(title);
+
+#if STL
+    typedef ft::map<int, std::string> wide_map;
+    typedef ft::set<long> wide_set;
+#else
+    typedef ft::btree_map<int, std::string> wide_map;
+    typedef ft::btree_set<long> wide_set;
+#endif
+    // Enough keys for several levels, inserted in increasing, decreasing and
+    // scattered order, then erased in runs so that nodes merge and borrow
+    wide_map names;
+    wide_set ids;
+    for (int i=0; i<20000; ++i) {
+      names.insert(names.end(), ft::make_pair(i * 3, std::string(i % 7 + 1, 'a' + i % 26)));
+      ids.insert(static_cast<long>(20000 - i) * 1000);
+      ids.insert(static_cast<long>(i * 7919 % 20011));
+    }
+    for (int i=0; i<60000; i += 9) names.erase(i);
+    names.erase(names.lower_bound(30000), names.lower_bound(45000));
+    for (long i=0; i<20011; i += 2) ids.erase(i);
+    wide_set::iterator from = ids.lower_bound(5000000);
+    wide_set::iterator to = ids.lower_bound(15000000);
+    ids.erase(from, to);
+
+    long sum = 0;
+    long backward = 0;
+    for (wide_map::iterator it = names.begin(); it != names.end(); ++it) sum += it->first * static_cast<long>(it->second.size());
+    for (wide_map::reverse_iterator rit = names.rbegin(); rit != names.rend(); ++rit) backward += rit->first * static_cast<long>(rit->second.size());
+    std::cout << "map: " << names.size() << ' ' << sum << ' ' << (sum == backward) << ' '
+              << names.begin()->first << ' ' << names.rbegin()->first << '\n';
+    std::cout << "bounds: " << names.lower_bound(29999)->first << ' ' << names.upper_bound(30000)->first << ' '
+              << names.count(45003) << ' ' << (names.find(45000) == names.end()) << '\n';
+
+    long id_sum = 0;
+    for (wide_set::const_iterator it = ids.begin(); it != ids.end(); ++it) id_sum += *it;
+    std::cout << "set: " << ids.size() << ' ' << id_sum << ' ' << *ids.begin() << ' ' << *ids.rbegin() << '\n';
+
+    wide_map copy(names);
+    copy[1] = "one";
+    std::cout << "copy: " << (copy == names) << ' ' << (names < copy) << ' ' << copy.size() << '\n';
+    copy.erase(copy.begin(), copy.end());
+    names.swap(copy);
+    std::cout << "swapped: " << names.size() << ' ' << copy.size() << ' ' << names.empty() << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "b-tree key search test";
+    start_test(title);
+
+#if STL
+    typedef ft::set<unsigned long> id_set;
+    typedef ft::set<unsigned> flag_set;
+    typedef ft::map<unsigned, int> code_map;
+    typedef ft::set<double> level_set;
+    typedef ft::map<long, std::string> offset_map;
+#else
+    typedef ft::btree_set<unsigned long> id_set;
+    typedef ft::btree_set<unsigned> flag_set;
+    typedef ft::btree_map<unsigned, int> code_map;
+    typedef ft::btree_set<double> level_set;
+    typedef ft::btree_map<long, std::string> offset_map;
+#endif
+    // Keys on both sides of the sign bit, which the vectorized searches of
+    // sets flip: SSE2 for unsigned, AVX2 for unsigned long (make btree_avx2)
+    const unsigned long top = std::numeric_limits<unsigned long>::max();
+    const unsigned flag_top = std::numeric_limits<unsigned>::max();
+    id_set ids;
+    flag_set flags;
+    code_map codes;
+    level_set levels;
+    offset_map offsets;
+    for (int i=0; i<3000; ++i) {
+      ids.insert(top - static_cast<unsigned long>(i) * 7);
+      ids.insert(top / 2 - 1500 + static_cast<unsigned long>(i));
+      ids.insert(static_cast<unsigned long>(i) * 3);
+      flags.insert(flag_top - static_cast<unsigned>(i) * 3);
+      flags.insert(flag_top / 2 - 1500 + static_cast<unsigned>(i));
+      flags.insert(static_cast<unsigned>(i) * 2);
+      codes[std::numeric_limits<unsigned>::max() - static_cast<unsigned>(i) * 5] = i;
+      codes[static_cast<unsigned>(i) * 11] = -i;
+      levels.insert((i - 1500) * 0.25);
+      offsets[(i - 1500) * 1000003L] = std::string(i % 3 + 1, 'o');
+    }
+    const unsigned long id_probes[] = {0, 1, 8999, top / 2, top / 2 + 1, top / 2 + 1500, top - 14, top - 13, top};
+    for (int i=0; i<9; ++i) {
+      id_set::iterator lo = ids.lower_bound(id_probes[i]);
+      id_set::iterator hi = ids.upper_bound(id_probes[i]);
+      std::cout << "id " << id_probes[i] << ": " << (lo == ids.end() ? 0 : *lo) << ' '
+                << (hi == ids.end() ? 0 : *hi) << ' ' << ids.count(id_probes[i]) << '\n';
+    }
+    const unsigned flag_probes[] = {0, 1, 5999, flag_top / 2, flag_top / 2 + 1, flag_top / 2 + 1500,
+                                    flag_top - 7, flag_top - 6, flag_top};
+    for (int i=0; i<9; ++i) {
+      flag_set::iterator lo = flags.lower_bound(flag_probes[i]);
+      flag_set::iterator hi = flags.upper_bound(flag_probes[i]);
+      std::cout << "flag " << flag_probes[i] << ": " << (lo == flags.end() ? 0 : *lo) << ' '
+                << (hi == flags.end() ? 0 : *hi) << ' ' << flags.count(flag_probes[i]) << '\n';
+    }
+    const unsigned code_probes[] = {0, 22, 32990, 4294967290u, 4294967295u};
+    for (int i=0; i<5; ++i) {
+      code_map::iterator it = codes.lower_bound(code_probes[i]);
+      std::cout << "code " << code_probes[i] << ": " << it->first << " => " << it->second << ' '
+                << (codes.find(code_probes[i]) != codes.end()) << '\n';
+    }
+    const double level_probes[] = {-1000.0, -375.1, -0.0, 0.125, 374.75, 1000.0};
+    for (int i=0; i<6; ++i) {
+      level_set::iterator lo = levels.lower_bound(level_probes[i]);
+      level_set::iterator hi = levels.upper_bound(level_probes[i]);
+      std::cout << "level " << level_probes[i] << ": " << (lo == levels.end() ? -1 : *lo) << ' '
+                << (hi == levels.end() ? -1 : *hi) << '\n';
+    }
+    offsets.erase(offsets.lower_bound(-1000003L * 700), offsets.upper_bound(1000003L * 700));
+    std::cout << "offsets: " << offsets.size() << ' ' << offsets.lower_bound(0)->first << ' '
+              << (--offsets.lower_bound(0))->first << ' ' << offsets.count(-1000003L * 701) << '\n';
+
+    end_test(title);
+  }
 
   std::cout << "=====Set test=====\n" << std::endl;
 
@@ -1899,5 +3164,75 @@ int main() {
 
     end_test(title);
   }
+
+#if __cplusplus >= 201103L
+  std::cout << "=====C++11 test=====\n" << std::endl;
+
+  {
+    std::string title = "move semantics test";
+    start_test(title);
+
+    ft::vector<std::string> words;
+    std::string hello("hello");
+    words.push_back(std::move(hello));
+    words.emplace_back(3, 'x');
+    words.emplace(words.begin(), "first");
+    words.insert(words.begin() + 1, std::string("second"));
+    print_container(words.begin(), words.end());
+
+    ft::vector<std::string> moved(std::move(words));
+    std::cout << "moved size: " << moved.size() << '\n';
+    words = std::move(moved);
+    print_container(words.begin(), words.end());
+
+    ft::map<std::string, int> ages;
+    std::cout << "emplace: " << ages.emplace("alice", 30).second;
+    std::cout << ' ' << ages.emplace("alice", 31).second << '\n';
+    ages.emplace_hint(ages.end(), "bob", 25);
+    ages.insert(ft::make_pair(std::string("carol"), 41));
+    ages[std::string("dave")] = 52;
+    ft::map<std::string, int> other(std::move(ages));
+    for (ft::map<std::string, int>::iterator it = other.begin(); it != other.end(); ++it)
+      std::cout << it->first << " => " << it->second << '\n';
+
+    ft::set<std::string> names;
+    names.emplace("zoe");
+    names.emplace_hint(names.begin(), "adam");
+    std::cout << "names: " << names.size() << ' ' << *names.begin() << '\n';
+
+    ft::stack<std::string> stk;
+    stk.emplace(2, 'y');
+    stk.push(std::string("top"));
+    ft::stack<std::string> stk2(std::move(stk));
+    std::cout << "stack top: " << stk2.top() << ' ' << stk2.size() << '\n';
+
+    end_test(title);
+  }
+  {
+    std::string title = "small_vector strong guarantee test";
+    start_test(title);
+
+#if STL
+    typedef ft::vector<Fragile> fragiles;
+#else
+    typedef ft::small_vector<Fragile, 4> fragiles;
+#endif
+    fragiles v;
+    v.reserve(4);
+    for (int i=1; i<=4; ++i) v.emplace_back(i);
+    Fragile::copies_left = 2;
+    try {
+      v.emplace_back(5);                     // outgrows the inline buffer
+    } catch (std::exception& e) {
+      std::cout << "caught: " << e.what() << '\n';
+    }
+    Fragile::copies_left = -1;
+    std::cout << "size: " << v.size() << ", elements:";
+    for (fragiles::iterator it = v.begin(); it != v.end(); ++it) std::cout << ' ' << it->n;
+    std::cout << '\n';
+
+    end_test(title);
+  }
+#endif
   return 0;
 }